@@ -18,5 +18,12 @@ iw dev wlan0 info
 #iw dev wlan0 set txpower fixed 1700
 #cat /proc/net/rtl8812cu/wlan0/tx_power_idx
 
+# Unix datagram queue defaults to 10 packets, too short for an IDR burst on -T unix
+echo 512 > /proc/sys/net/unix/max_dgram_qlen
+
 /usr/bin/wfb_tx -p 0 -u 5602 -K /vtx/wfb_ng/drone.key wlan0 &
 /vtx/bin/luckfox_pico_rtp -i 127.0.0.1 -p 5000 -w 1920 -h 1080 -f 90 -e 1 -b 2
+
+# Local shared memory transport (wfb_tx built with patches/0001-tx-local-input.patch):
+#/usr/bin/wfb_tx -p 0 -U /var/run/wfb_tx.sock -K /vtx/wfb_ng/drone.key wlan0 &
+#/vtx/bin/luckfox_pico_rtp -w 1920 -h 1080 -f 90 -e 1 -b 2 -T shm:/var/run/wfb_tx.sock
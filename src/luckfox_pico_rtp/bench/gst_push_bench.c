@@ -0,0 +1,968 @@
+#define _GNU_SOURCE
+#include <stdio.h>      // 标准输入输出库
+#include <stdlib.h>     // 提供atoi、exit等函数
+#include <string.h>     // 提供memcpy、memset等函数
+#include <unistd.h>     // 提供getopt等POSIX接口
+#include <time.h>       // 提供clock_gettime
+#include <dlfcn.h>      // 提供dlsym，用于拦截内存分配和系统调用
+#include <poll.h>       // 提供poll相关定义
+#include <sys/socket.h> // 提供sendmsg等套接字接口
+#include <sys/uio.h>    // 提供writev定义
+#include <sys/un.h>     // 提供Unix套接字地址定义
+#include <netinet/in.h> // 提供sockaddr_in定义
+#include <arpa/inet.h>  // 提供htons等函数
+#include <pthread.h>    // 提供消费者线程
+
+#include "gst_push.h" // 被测试的GStreamer推流模块
+#include "shm_ring.h" // 共享内存环形队列
+
+#define DEFAULT_FRAMES 1000     // 每个测试用例的默认帧数
+#define DEFAULT_BENCH_PORT 5699 // 推流测试使用的本地UDP端口
+#define BENCH_FPS 90            // 推流测试使用的帧率
+#define BENCH_GOP 15            // 推流测试使用的GOP大小
+#define BOOTSTRAP_SIZE 8192     // dlsym解析期间使用的临时内存池大小
+#define BENCH_SOCK_PATH "/tmp/gst_push_bench.sock" // 本地传输测试使用的套接字路径
+
+/*============================================================================
+ * 内存分配和系统调用计数
+ *
+ * 通过符号插桩拦截malloc系列函数以及热路径上常见的系统调用包装函数（发送、写入、poll），
+ * 统计所有线程的调用次数。futex等由libc内部直接发起的系统调用无法被拦截，不计入统计。
+ *============================================================================*/
+static unsigned long alloc_count = 0;   // 内存分配次数
+static unsigned long syscall_count = 0; // 系统调用次数
+
+static void *(*real_malloc)(size_t) = NULL;
+static void *(*real_calloc)(size_t, size_t) = NULL;
+static void *(*real_realloc)(void *, size_t) = NULL;
+static void (*real_free)(void *) = NULL;
+static int (*real_posix_memalign)(void **, size_t, size_t) = NULL;
+static void *(*real_memalign)(size_t, size_t) = NULL;
+static ssize_t (*real_sendmsg)(int, const struct msghdr *, int) = NULL;
+static int (*real_sendmmsg)(int, struct mmsghdr *, unsigned int, int) = NULL;
+static ssize_t (*real_sendto)(int, const void *, size_t, int, const struct sockaddr *, socklen_t) = NULL;
+static ssize_t (*real_write)(int, const void *, size_t) = NULL;
+static ssize_t (*real_writev)(int, const struct iovec *, int) = NULL;
+static ssize_t (*real_read)(int, void *, size_t) = NULL;
+static int (*real_poll)(struct pollfd *, nfds_t, int) = NULL;
+
+static char bootstrap[BOOTSTRAP_SIZE]; // dlsym内部分配内存时使用的临时内存池
+static size_t bootstrap_used = 0;
+static int resolving = 0;
+
+#define COUNT(counter) __atomic_fetch_add(&(counter), 1, __ATOMIC_RELAXED)
+#define IS_BOOTSTRAP(ptr) ((char *)(ptr) >= bootstrap && (char *)(ptr) < bootstrap + BOOTSTRAP_SIZE)
+
+/**
+ * @brief 解析被拦截函数的真实地址
+ */
+static void resolve_symbols(void)
+{
+    resolving = 1;
+    real_malloc = dlsym(RTLD_NEXT, "malloc");
+    real_calloc = dlsym(RTLD_NEXT, "calloc");
+    real_realloc = dlsym(RTLD_NEXT, "realloc");
+    real_free = dlsym(RTLD_NEXT, "free");
+    real_posix_memalign = dlsym(RTLD_NEXT, "posix_memalign");
+    real_memalign = dlsym(RTLD_NEXT, "memalign");
+    real_sendmsg = dlsym(RTLD_NEXT, "sendmsg");
+    real_sendmmsg = dlsym(RTLD_NEXT, "sendmmsg");
+    real_sendto = dlsym(RTLD_NEXT, "sendto");
+    real_write = dlsym(RTLD_NEXT, "write");
+    real_writev = dlsym(RTLD_NEXT, "writev");
+    real_read = dlsym(RTLD_NEXT, "read");
+    real_poll = dlsym(RTLD_NEXT, "poll");
+    resolving = 0;
+}
+
+/**
+ * @brief 从临时内存池中分配内存，仅在dlsym解析期间使用
+ */
+static void *bootstrap_alloc(size_t size)
+{
+    size = (size + 15) & ~(size_t)15;
+    if (bootstrap_used + size > BOOTSTRAP_SIZE)
+    {
+        return NULL;
+    }
+    void *ptr = bootstrap + bootstrap_used;
+    bootstrap_used += size;
+    return ptr;
+}
+
+void *malloc(size_t size)
+{
+    if (real_malloc == NULL)
+    {
+        if (resolving)
+        {
+            return bootstrap_alloc(size);
+        }
+        resolve_symbols();
+    }
+    COUNT(alloc_count);
+    return real_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    if (real_calloc == NULL)
+    {
+        if (resolving)
+        {
+            return bootstrap_alloc(nmemb * size); // 静态内存池已清零
+        }
+        resolve_symbols();
+    }
+    COUNT(alloc_count);
+    return real_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    if (real_realloc == NULL)
+    {
+        resolve_symbols();
+    }
+    if (IS_BOOTSTRAP(ptr))
+    {
+        size_t avail = bootstrap + BOOTSTRAP_SIZE - (char *)ptr; // 原内存块大小未知，最多拷贝到内存池末尾
+        void *new_ptr = malloc(size);
+        if (new_ptr != NULL)
+        {
+            memcpy(new_ptr, ptr, size < avail ? size : avail);
+        }
+        return new_ptr;
+    }
+    COUNT(alloc_count);
+    return real_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    if (ptr == NULL || IS_BOOTSTRAP(ptr))
+    {
+        return;
+    }
+    if (real_free == NULL)
+    {
+        resolve_symbols();
+    }
+    real_free(ptr);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    if (real_posix_memalign == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(alloc_count);
+    return real_posix_memalign(memptr, alignment, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    if (real_memalign == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(alloc_count);
+    return real_memalign(alignment, size);
+}
+
+ssize_t sendmsg(int sockfd, const struct msghdr *msg, int flags)
+{
+    if (real_sendmsg == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(syscall_count);
+    return real_sendmsg(sockfd, msg, flags);
+}
+
+int sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    if (real_sendmmsg == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(syscall_count);
+    return real_sendmmsg(sockfd, msgvec, vlen, flags);
+}
+
+ssize_t sendto(int sockfd, const void *buf, size_t len, int flags, const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+    if (real_sendto == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(syscall_count);
+    return real_sendto(sockfd, buf, len, flags, dest_addr, addrlen);
+}
+
+ssize_t write(int fd, const void *buf, size_t count)
+{
+    if (real_write == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(syscall_count);
+    return real_write(fd, buf, count);
+}
+
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    if (real_writev == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(syscall_count);
+    return real_writev(fd, iov, iovcnt);
+}
+
+ssize_t read(int fd, void *buf, size_t count)
+{
+    if (real_read == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(syscall_count);
+    return real_read(fd, buf, count);
+}
+
+int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    if (real_poll == NULL)
+    {
+        resolve_symbols();
+    }
+    COUNT(syscall_count);
+    return real_poll(fds, nfds, timeout);
+}
+
+/*============================================================================
+ * 合成码流
+ *
+ * 生成带有合法参数集和片头的H.264/H.265码流，片数据部分为不含起始码的伪随机字节，
+ * 使解析器和RTP打包器能够正常协商和处理，而无需真实的编码器。
+ *============================================================================*/
+
+// 定义一个结构体，用于按位写入RBSP
+typedef struct
+{
+    uint8_t buf[64]; // RBSP缓冲区，参数集和片头都远小于该长度
+    int bits;        // 已写入的位数
+} BitWriter_S;
+
+static void bw_put(BitWriter_S *bw, uint32_t value, int n)
+{
+    for (int i = n - 1; i >= 0; i--)
+    {
+        if ((value >> i) & 1)
+        {
+            bw->buf[bw->bits >> 3] |= 0x80 >> (bw->bits & 7);
+        }
+        bw->bits++;
+    }
+}
+
+static void bw_ue(BitWriter_S *bw, uint32_t value)
+{
+    uint32_t v = value + 1;
+    int len = 0;
+    while ((v >> len) > 1)
+    {
+        len++;
+    }
+    bw_put(bw, 0, len);
+    bw_put(bw, v, len + 1);
+}
+
+static void bw_se(BitWriter_S *bw, int32_t value)
+{
+    bw_ue(bw, value > 0 ? (uint32_t)(2 * value - 1) : (uint32_t)(-2 * value));
+}
+
+// rbsp_trailing_bits / byte_alignment：写入1后补0至字节对齐
+static void bw_trailing(BitWriter_S *bw)
+{
+    bw_put(bw, 1, 1);
+    while (bw->bits & 7)
+    {
+        bw_put(bw, 0, 1);
+    }
+}
+
+/**
+ * @brief 写入一个带起始码的NAL单元，并插入防竞争字节
+ *
+ * @return size_t 写入的字节数
+ */
+static size_t emit_nal(uint8_t *out, const uint8_t *header, int header_len, const BitWriter_S *bw)
+{
+    size_t pos = 0;
+    int zeros = 0;
+
+    out[pos++] = 0;
+    out[pos++] = 0;
+    out[pos++] = 0;
+    out[pos++] = 1;
+    memcpy(out + pos, header, header_len);
+    pos += header_len;
+
+    for (int i = 0; i < (bw->bits + 7) / 8; i++)
+    {
+        if (zeros == 2 && bw->buf[i] <= 3)
+        {
+            out[pos++] = 3; // 防竞争字节
+            zeros = 0;
+        }
+        out[pos++] = bw->buf[i];
+        zeros = bw->buf[i] == 0 ? zeros + 1 : 0;
+    }
+
+    return pos;
+}
+
+static void h265_profile_tier_level(BitWriter_S *bw)
+{
+    bw_put(bw, 0, 2);          // general_profile_space
+    bw_put(bw, 0, 1);          // general_tier_flag
+    bw_put(bw, 1, 5);          // general_profile_idc = Main
+    bw_put(bw, 0x60000000, 32); // general_profile_compatibility_flag[1..2]
+    bw_put(bw, 1, 1);          // general_progressive_source_flag
+    bw_put(bw, 0, 1);          // general_interlaced_source_flag
+    bw_put(bw, 0, 1);          // general_non_packed_constraint_flag
+    bw_put(bw, 1, 1);          // general_frame_only_constraint_flag
+    bw_put(bw, 0, 32);         // general_reserved_zero_44bits
+    bw_put(bw, 0, 12);
+    bw_put(bw, 123, 8);        // general_level_idc = 4.1
+}
+
+/**
+ * @brief 生成1920x1080的H.265 VPS/SPS/PPS
+ */
+static size_t h265_parameter_sets(uint8_t *out)
+{
+    size_t pos = 0;
+    BitWriter_S bw;
+
+    // VPS
+    memset(&bw, 0, sizeof(bw));
+    bw_put(&bw, 0, 4);      // vps_video_parameter_set_id
+    bw_put(&bw, 3, 2);      // vps_base_layer_internal_flag, vps_base_layer_available_flag
+    bw_put(&bw, 0, 6);      // vps_max_layers_minus1
+    bw_put(&bw, 0, 3);      // vps_max_sub_layers_minus1
+    bw_put(&bw, 1, 1);      // vps_temporal_id_nesting_flag
+    bw_put(&bw, 0xffff, 16); // vps_reserved_0xffff_16bits
+    h265_profile_tier_level(&bw);
+    bw_put(&bw, 0, 1);      // vps_sub_layer_ordering_info_present_flag
+    bw_ue(&bw, 1);          // vps_max_dec_pic_buffering_minus1
+    bw_ue(&bw, 0);          // vps_max_num_reorder_pics
+    bw_ue(&bw, 0);          // vps_max_latency_increase_plus1
+    bw_put(&bw, 0, 6);      // vps_max_layer_id
+    bw_ue(&bw, 0);          // vps_num_layer_sets_minus1
+    bw_put(&bw, 0, 1);      // vps_timing_info_present_flag
+    bw_put(&bw, 0, 1);      // vps_extension_flag
+    bw_trailing(&bw);
+    pos += emit_nal(out + pos, (const uint8_t[]){32 << 1, 1}, 2, &bw);
+
+    // SPS
+    memset(&bw, 0, sizeof(bw));
+    bw_put(&bw, 0, 4); // sps_video_parameter_set_id
+    bw_put(&bw, 0, 3); // sps_max_sub_layers_minus1
+    bw_put(&bw, 1, 1); // sps_temporal_id_nesting_flag
+    h265_profile_tier_level(&bw);
+    bw_ue(&bw, 0);     // sps_seq_parameter_set_id
+    bw_ue(&bw, 1);     // chroma_format_idc = 4:2:0
+    bw_ue(&bw, 1920);  // pic_width_in_luma_samples
+    bw_ue(&bw, 1080);  // pic_height_in_luma_samples
+    bw_put(&bw, 0, 1); // conformance_window_flag
+    bw_ue(&bw, 0);     // bit_depth_luma_minus8
+    bw_ue(&bw, 0);     // bit_depth_chroma_minus8
+    bw_ue(&bw, 4);     // log2_max_pic_order_cnt_lsb_minus4
+    bw_put(&bw, 1, 1); // sps_sub_layer_ordering_info_present_flag
+    bw_ue(&bw, 1);     // sps_max_dec_pic_buffering_minus1
+    bw_ue(&bw, 0);     // sps_max_num_reorder_pics
+    bw_ue(&bw, 0);     // sps_max_latency_increase_plus1
+    bw_ue(&bw, 0);     // log2_min_luma_coding_block_size_minus3
+    bw_ue(&bw, 3);     // log2_diff_max_min_luma_coding_block_size
+    bw_ue(&bw, 0);     // log2_min_luma_transform_block_size_minus2
+    bw_ue(&bw, 3);     // log2_diff_max_min_luma_transform_block_size
+    bw_ue(&bw, 0);     // max_transform_hierarchy_depth_inter
+    bw_ue(&bw, 0);     // max_transform_hierarchy_depth_intra
+    bw_put(&bw, 0, 4); // scaling_list, amp, sample_adaptive_offset, pcm
+    bw_ue(&bw, 0);     // num_short_term_ref_pic_sets
+    bw_put(&bw, 0, 5); // long_term_ref_pics_present, sps_temporal_mvp, strong_intra_smoothing, vui, sps_extension
+    bw_trailing(&bw);
+    pos += emit_nal(out + pos, (const uint8_t[]){33 << 1, 1}, 2, &bw);
+
+    // PPS
+    memset(&bw, 0, sizeof(bw));
+    bw_ue(&bw, 0);      // pps_pic_parameter_set_id
+    bw_ue(&bw, 0);      // pps_seq_parameter_set_id
+    bw_put(&bw, 0, 7);  // dependent_slice_segments, output_flag_present, num_extra_slice_header_bits(3), sign_data_hiding, cabac_init_present
+    bw_ue(&bw, 0);      // num_ref_idx_l0_default_active_minus1
+    bw_ue(&bw, 0);      // num_ref_idx_l1_default_active_minus1
+    bw_se(&bw, 0);      // init_qp_minus26
+    bw_put(&bw, 0, 3);  // constrained_intra_pred, transform_skip, cu_qp_delta
+    bw_se(&bw, 0);      // pps_cb_qp_offset
+    bw_se(&bw, 0);      // pps_cr_qp_offset
+    bw_put(&bw, 0, 10); // slice_chroma_qp_offsets_present ... lists_modification_present
+    bw_ue(&bw, 0);      // log2_parallel_merge_level_minus2
+    bw_put(&bw, 0, 2);  // slice_segment_header_extension_present, pps_extension_present
+    bw_trailing(&bw);
+    pos += emit_nal(out + pos, (const uint8_t[]){34 << 1, 1}, 2, &bw);
+
+    return pos;
+}
+
+/**
+ * @brief 生成1920x1080的H.264 SPS/PPS
+ */
+static size_t h264_parameter_sets(uint8_t *out)
+{
+    size_t pos = 0;
+    BitWriter_S bw;
+
+    // SPS
+    memset(&bw, 0, sizeof(bw));
+    bw_put(&bw, 77, 8);   // profile_idc = Main
+    bw_put(&bw, 0x40, 8); // constraint_set1_flag
+    bw_put(&bw, 40, 8);   // level_idc = 4.0
+    bw_ue(&bw, 0);        // seq_parameter_set_id
+    bw_ue(&bw, 0);        // log2_max_frame_num_minus4
+    bw_ue(&bw, 2);        // pic_order_cnt_type
+    bw_ue(&bw, 1);        // max_num_ref_frames
+    bw_put(&bw, 0, 1);    // gaps_in_frame_num_value_allowed_flag
+    bw_ue(&bw, 119);      // pic_width_in_mbs_minus1
+    bw_ue(&bw, 67);       // pic_height_in_map_units_minus1
+    bw_put(&bw, 3, 2);    // frame_mbs_only_flag, direct_8x8_inference_flag
+    bw_put(&bw, 1, 1);    // frame_cropping_flag
+    bw_ue(&bw, 0);        // frame_crop_left_offset
+    bw_ue(&bw, 0);        // frame_crop_right_offset
+    bw_ue(&bw, 0);        // frame_crop_top_offset
+    bw_ue(&bw, 4);        // frame_crop_bottom_offset，1088裁剪为1080
+    bw_put(&bw, 0, 1);    // vui_parameters_present_flag
+    bw_trailing(&bw);
+    pos += emit_nal(out + pos, (const uint8_t[]){0x67}, 1, &bw);
+
+    // PPS
+    memset(&bw, 0, sizeof(bw));
+    bw_ue(&bw, 0);     // pic_parameter_set_id
+    bw_ue(&bw, 0);     // seq_parameter_set_id
+    bw_put(&bw, 0, 2); // entropy_coding_mode_flag, bottom_field_pic_order_in_frame_present_flag
+    bw_ue(&bw, 0);     // num_slice_groups_minus1
+    bw_ue(&bw, 0);     // num_ref_idx_l0_default_active_minus1
+    bw_ue(&bw, 0);     // num_ref_idx_l1_default_active_minus1
+    bw_put(&bw, 0, 3); // weighted_pred_flag, weighted_bipred_idc
+    bw_se(&bw, 0);     // pic_init_qp_minus26
+    bw_se(&bw, 0);     // pic_init_qs_minus26
+    bw_se(&bw, 0);     // chroma_qp_index_offset
+    bw_put(&bw, 4, 3); // deblocking_filter_control_present_flag, constrained_intra_pred_flag, redundant_pic_cnt_present_flag
+    bw_trailing(&bw);
+    pos += emit_nal(out + pos, (const uint8_t[]){0x68}, 1, &bw);
+
+    return pos;
+}
+
+/**
+ * @brief 生成一个片的NAL头和片头
+ *
+ * @param h265 TRUE为H.265，FALSE为H.264
+ * @param idr 是否为IDR帧
+ * @param index 帧序号，用于POC/frame_num
+ */
+static size_t slice_header(uint8_t *out, gboolean h265, gboolean idr, uint32_t index)
+{
+    BitWriter_S bw;
+    memset(&bw, 0, sizeof(bw));
+
+    if (h265)
+    {
+        bw_put(&bw, 1, 1); // first_slice_segment_in_pic_flag
+        if (idr)
+        {
+            bw_put(&bw, 0, 1); // no_output_of_prior_pics_flag
+        }
+        bw_ue(&bw, 0);             // slice_pic_parameter_set_id
+        bw_ue(&bw, idr ? 2 : 1);   // slice_type: I / P
+        if (!idr)
+        {
+            bw_put(&bw, index & 0xff, 8); // slice_pic_order_cnt_lsb
+            bw_put(&bw, 0, 1);            // short_term_ref_pic_set_sps_flag
+            bw_ue(&bw, 1);                // num_negative_pics
+            bw_ue(&bw, 0);                // num_positive_pics
+            bw_ue(&bw, 0);                // delta_poc_s0_minus1
+            bw_put(&bw, 1, 1);            // used_by_curr_pic_s0_flag
+            bw_put(&bw, 0, 1);            // num_ref_idx_active_override_flag
+            bw_ue(&bw, 0);                // five_minus_max_num_merge_cand
+        }
+        bw_se(&bw, 0);     // slice_qp_delta
+        bw_trailing(&bw);  // byte_alignment
+        return emit_nal(out, (const uint8_t[]){(idr ? 19 : 1) << 1, 1}, 2, &bw);
+    }
+
+    bw_ue(&bw, 0);             // first_mb_in_slice
+    bw_ue(&bw, idr ? 7 : 5);   // slice_type: I / P
+    bw_ue(&bw, 0);             // pic_parameter_set_id
+    bw_put(&bw, index & 0xf, 4); // frame_num
+    if (idr)
+    {
+        bw_ue(&bw, 0);     // idr_pic_id
+        bw_put(&bw, 0, 2); // no_output_of_prior_pics_flag, long_term_reference_flag
+    }
+    else
+    {
+        bw_put(&bw, 0, 3); // num_ref_idx_active_override_flag, ref_pic_list_modification_flag_l0, adaptive_ref_pic_marking_mode_flag
+    }
+    bw_se(&bw, 0);     // slice_qp_delta
+    bw_ue(&bw, 0);     // disable_deblocking_filter_idc
+    bw_se(&bw, 0);     // slice_alpha_c0_offset_div2
+    bw_se(&bw, 0);     // slice_beta_offset_div2
+    bw_trailing(&bw);
+    return emit_nal(out, (const uint8_t[]){idr ? 0x65 : 0x41}, 1, &bw);
+}
+
+/**
+ * @brief 生成一帧指定大小的合成码流，IDR帧前附带参数集
+ *
+ * @return size_t 帧的实际大小
+ */
+static size_t make_frame(uint8_t *out, size_t size, gboolean h265, gboolean idr, uint32_t index)
+{
+    size_t pos = 0;
+    uint32_t seed = index * 2654435761u + 1;
+
+    if (idr)
+    {
+        pos += h265 ? h265_parameter_sets(out) : h264_parameter_sets(out);
+    }
+    pos += slice_header(out + pos, h265, idr, index);
+
+    // 片数据使用非零伪随机字节填充，保证不会出现起始码
+    while (pos < size)
+    {
+        seed = seed * 1103515245u + 12345u;
+        uint8_t b = (uint8_t)(seed >> 16);
+        out[pos++] = b ? b : 0x55;
+    }
+
+    return pos;
+}
+
+/*============================================================================
+ * 测试用例
+ *============================================================================*/
+
+// 定义一个结构体，用于描述测试用例
+typedef struct
+{
+    const char *name;  // 测试名称
+    size_t frame_size; // 帧大小（字节）
+    gboolean idr;      // TRUE为全部IDR帧，FALSE为首帧IDR后接P帧
+} BenchCase_S;
+
+static const BenchCase_S bench_cases[] = {
+    {"p_2k", 2 * 1024, FALSE},
+    {"p_8k", 8 * 1024, FALSE},
+    {"p_32k", 32 * 1024, FALSE},
+    {"idr_128k", 128 * 1024, TRUE},
+    {"idr_512k", 512 * 1024, TRUE},
+};
+
+static const char *bench_tag = "none"; // 结果标签，通常为提交哈希
+
+static uint64_t now_ns(clockid_t clock_id)
+{
+    struct timespec ts;
+    clock_gettime(clock_id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// 定义一个结构体，用于保存一次测量的起点
+typedef struct
+{
+    uint64_t wall;
+    uint64_t cpu;
+    unsigned long allocs;
+    unsigned long syscalls;
+    long packets_received; // 消费者收到的RTP包数，-1 表示不适用
+    long packets_dropped;  // 发送端丢弃的RTP包数（本地传输通道），-1 表示不适用
+} Sample_S;
+
+static void sample_begin(Sample_S *s)
+{
+    s->packets_received = -1;
+    s->packets_dropped = -1;
+    s->allocs = __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
+    s->syscalls = __atomic_load_n(&syscall_count, __ATOMIC_RELAXED);
+    s->cpu = now_ns(CLOCK_PROCESS_CPUTIME_ID);
+    s->wall = now_ns(CLOCK_MONOTONIC);
+}
+
+/**
+ * @brief 以JSON行格式输出测量结果，便于按提交追踪性能回归
+ */
+static void sample_end(const Sample_S *s, const char *bench, const char *codec, const BenchCase_S *bc, int frames)
+{
+    uint64_t wall = now_ns(CLOCK_MONOTONIC) - s->wall;
+    uint64_t cpu = now_ns(CLOCK_PROCESS_CPUTIME_ID) - s->cpu;
+    unsigned long allocs = __atomic_load_n(&alloc_count, __ATOMIC_RELAXED) - s->allocs;
+    unsigned long syscalls = __atomic_load_n(&syscall_count, __ATOMIC_RELAXED) - s->syscalls;
+
+    printf("{\"tag\":\"%s\",\"bench\":\"%s\",\"codec\":\"%s\",\"case\":\"%s\",\"frame_bytes\":%zu,\"frames\":%d,"
+           "\"ns_per_frame\":%.1f,\"cpu_ns_per_frame\":%.1f,\"allocs_per_frame\":%.2f,\"syscalls_per_frame\":%.2f",
+           bench_tag, bench, codec, bc->name, bc->frame_size, frames,
+           (double)wall / frames, (double)cpu / frames, (double)allocs / frames, (double)syscalls / frames);
+    // 推流测试附带收发包数，丢包时每帧的开销不可比
+    if (s->packets_received >= 0)
+    {
+        printf(",\"packets_received\":%ld", s->packets_received);
+    }
+    if (s->packets_dropped >= 0)
+    {
+        printf(",\"packets_dropped\":%ld", s->packets_dropped);
+    }
+    printf("}\n");
+    fflush(stdout);
+}
+
+/**
+ * @brief 测试GStreamer缓冲区的分配、填充和释放，与gst_push_data()中的路径一致
+ */
+static void bench_alloc(const BenchCase_S *bc, uint8_t *data, int frames)
+{
+    Sample_S s;
+    sample_begin(&s);
+    for (int i = 0; i < frames; i++)
+    {
+        GstBuffer *buf = gst_buffer_new_allocate(NULL, bc->frame_size, NULL);
+        gst_buffer_fill(buf, 0, data, bc->frame_size);
+        gst_buffer_unref(buf);
+    }
+    sample_end(&s, "alloc", "none", bc, frames);
+}
+
+/**
+ * @brief 测试解析器或解析器加RTP打包器的处理开销，输出到fakesink
+ *
+ * @param with_payloader FALSE只测试NAL扫描解析，TRUE同时测试RTP打包
+ */
+static void bench_pipeline(const BenchCase_S *bc, uint8_t **data, int frames, gboolean h265, gboolean with_payloader)
+{
+    const char *codec = h265 ? "h265" : "h264";
+    char desc[256];
+    snprintf(desc, sizeof(desc),
+             "appsrc name=src is-live=true format=time caps=video/x-%s,stream-format=byte-stream ! %sparse ! %s%s%s fakesink sync=false",
+             codec, codec, with_payloader ? "rtp" : "", with_payloader ? codec : "", with_payloader ? "pay !" : "");
+
+    GstElement *pipeline = gst_parse_launch(desc, NULL);
+    if (pipeline == NULL)
+    {
+        g_printerr("Failed to create pipeline: %s\n", desc);
+        return;
+    }
+    GstElement *src = gst_bin_get_by_name(GST_BIN(pipeline), "src");
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+
+    Sample_S s;
+    sample_begin(&s);
+    for (int i = 0; i < frames; i++)
+    {
+        GstBuffer *buf = gst_buffer_new_allocate(NULL, bc->frame_size, NULL);
+        gst_buffer_fill(buf, 0, data[i % BENCH_GOP], bc->frame_size);
+        GST_BUFFER_PTS(buf) = gst_util_uint64_scale(i, GST_SECOND, BENCH_FPS);
+        gst_app_src_push_buffer(GST_APP_SRC(src), buf);
+    }
+    gst_app_src_end_of_stream(GST_APP_SRC(src));
+
+    // 等待所有帧处理完毕
+    GstBus *bus = gst_element_get_bus(pipeline);
+    GstMessage *msg = gst_bus_timed_pop_filtered(bus, GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    sample_end(&s, with_payloader ? "packetize" : "parse", codec, bc, frames);
+
+    gst_message_unref(msg);
+    gst_object_unref(bus);
+    gst_object_unref(src);
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(pipeline);
+}
+
+// 定义一个结构体，描述模拟wfb_tx的本地消费者线程
+typedef struct
+{
+    TransportType_E type;   // 传输方式
+    int fd;                 // 接收套接字（共享内存模式下为门铃）
+    ShmRingHeader_S *ring;  // 共享内存环形队列
+    volatile int stop;      // 停止标志，置位后消费者取完剩余数据再退出
+    unsigned long packets;  // 收到的包数
+} BenchConsumer_S;
+
+/**
+ * @brief 消费者线程：与打过补丁的wfb_tx相同，poll等待后非阻塞地取完所有包
+ */
+static void *consumer_thread(void *arg)
+{
+    BenchConsumer_S *consumer = (BenchConsumer_S *)arg;
+    uint8_t buf[SHM_RING_SLOT_SIZE];
+    struct pollfd pfd = {consumer->fd, POLLIN, 0};
+
+    for (;;)
+    {
+        if (consumer->ring != NULL)
+        {
+            uint32_t len;
+            while (shm_ring_peek(consumer->ring, &len) != NULL)
+            {
+                consumer->packets++;
+                shm_ring_release(consumer->ring);
+            }
+            if (shm_ring_arm(consumer->ring))
+            {
+                continue; // 置位等待标志后仍有数据，不进入等待
+            }
+        }
+
+        // 停止后不再等待，套接字中没有剩余数据时退出
+        if (poll(&pfd, 1, consumer->stop ? 0 : 100) > 0)
+        {
+            while (recv(consumer->fd, buf, sizeof(buf), MSG_DONTWAIT) >= 0)
+            {
+                if (consumer->ring == NULL)
+                {
+                    consumer->packets++; // 共享内存模式下的零长度数据报只是门铃
+                }
+            }
+        }
+        else if (consumer->stop)
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 创建消费者的接收套接字并启动消费者线程
+ */
+static int consumer_start(BenchConsumer_S *consumer, pthread_t *thread, TransportType_E type, uint16_t port)
+{
+    int rcvbuf = 4 * 1024 * 1024;
+    memset(consumer, 0, sizeof(*consumer));
+    consumer->type = type;
+
+    if (type == TransportType_E_UDP)
+    {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        consumer->fd = socket(AF_INET, SOCK_DGRAM, 0);
+        setsockopt(consumer->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        if (bind(consumer->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            close(consumer->fd);
+            return -1;
+        }
+    }
+    else
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, BENCH_SOCK_PATH);
+        unlink(BENCH_SOCK_PATH);
+        consumer->fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        setsockopt(consumer->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        if (bind(consumer->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            close(consumer->fd);
+            return -1;
+        }
+        if (type == TransportType_E_SHM)
+        {
+            consumer->ring = shm_ring_open(BENCH_SOCK_PATH);
+            if (consumer->ring == NULL)
+            {
+                close(consumer->fd);
+                return -1;
+            }
+            shm_ring_reset(consumer->ring);
+        }
+    }
+
+    return pthread_create(thread, NULL, consumer_thread, consumer);
+}
+
+/**
+ * @brief 等待消费者取完剩余数据，停止消费者线程并释放资源
+ */
+static void consumer_stop(BenchConsumer_S *consumer, pthread_t thread)
+{
+    consumer->stop = 1;
+    pthread_join(thread, NULL);
+    close(consumer->fd);
+    if (consumer->ring != NULL)
+    {
+        g_printerr("shm ring dropped %u packets\n", shm_ring_take_dropped(consumer->ring));
+        shm_ring_close(consumer->ring);
+        shm_unlink(strrchr(BENCH_SOCK_PATH, '/'));
+    }
+    if (consumer->type != TransportType_E_UDP)
+    {
+        unlink(BENCH_SOCK_PATH);
+    }
+    g_printerr("consumer received %lu packets\n", consumer->packets);
+}
+
+/**
+ * @brief 测试完整的推流路径：gst_push_data()经解析、RTP打包后交给本地消费者
+ *
+ * @details 消费者线程的CPU时间计入测量，以便比较UDP回环、Unix数据报和共享内存三种传输方式的总开销。
+ */
+static void bench_push(const BenchCase_S *bc, uint8_t **data, int frames, gboolean h265, uint16_t port, TransportType_E transport)
+{
+    static const char *bench_names[] = {"push", "push_unix", "push_shm"};
+
+    BenchConsumer_S consumer;
+    pthread_t thread;
+    if (consumer_start(&consumer, &thread, transport, port) != 0)
+    {
+        g_printerr("start consumer fail!\n");
+        return;
+    }
+
+    GstPushInitParameter_S param;
+    memset(&param, 0, sizeof(param));
+    param.host_ip = (char *)"127.0.0.1";
+    param.host_port = port;
+    param.encodec_type = h265 ? EncondecType_E_H265 : EncondecType_E_H264;
+    param.fps = BENCH_FPS;
+    param.transport_type = transport;
+    param.transport_path = BENCH_SOCK_PATH;
+
+    if (gst_push_init(&param) != 0)
+    {
+        g_printerr("gst push init fail!\n");
+        consumer_stop(&consumer, thread);
+        return;
+    }
+
+    FrameData_S frame;
+    Sample_S s;
+    sample_begin(&s);
+    for (int i = 0; i < frames; i++)
+    {
+        frame.buffer = data[i % BENCH_GOP];
+        frame.size = bc->frame_size;
+        frame.pts = gst_util_uint64_scale(i, GST_SECOND, BENCH_FPS);
+        gst_push_data(&frame);
+    }
+    // gst_push_deinit()会发送EOS并等待所有帧发送完毕
+    gst_push_deinit();
+    consumer_stop(&consumer, thread);
+    s.packets_received = (long)consumer.packets;
+    if (transport != TransportType_E_UDP)
+    {
+        uint32_t sent, dropped; // 本地传输通道的发送、丢弃包数
+        local_transport_take_stats(&sent, &dropped);
+        s.packets_dropped = dropped;
+    }
+    sample_end(&s, bench_names[transport], h265 ? "h265" : "h264", bc, frames);
+}
+
+/**
+ * @brief 将g_print()的输出重定向到标准错误
+ */
+static void print_to_stderr(const gchar *string)
+{
+    fputs(string, stderr);
+}
+
+/**
+ * @brief 程序的使用说明
+ */
+static void display_usage(const char *program_name)
+{
+    fprintf(stderr, "Usage: %s [-n frames] [-e encodec(0:H264, 1:H265, 2:both)] [-p udp_port] [-t tag]\n", program_name);
+    fprintf(stderr, "For example: %s -n 1000 -e 2 -p %d -t $(git rev-parse --short HEAD)\n", program_name, DEFAULT_BENCH_PORT);
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = DEFAULT_FRAMES;
+    int encodec = 1;
+    uint16_t port = DEFAULT_BENCH_PORT;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:e:p:t:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            frames = atoi(optarg);
+            break;
+        case 'e':
+            encodec = atoi(optarg);
+            break;
+        case 'p':
+            port = atoi(optarg);
+            break;
+        case 't':
+            bench_tag = optarg;
+            break;
+        default:
+            display_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (frames <= 0 || encodec < 0 || encodec > 2)
+    {
+        display_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    gst_init(NULL, NULL);
+    g_set_print_handler(print_to_stderr); // 标准输出只保留测量结果
+
+    for (int h265 = 0; h265 <= 1; h265++)
+    {
+        if (encodec != 2 && encodec != h265)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++)
+        {
+            const BenchCase_S *bc = &bench_cases[i];
+
+            // 预先生成一个GOP的帧数据，避免生成开销计入测量
+            uint8_t *data[BENCH_GOP];
+            for (int j = 0; j < BENCH_GOP; j++)
+            {
+                data[j] = g_malloc(bc->frame_size);
+                make_frame(data[j], bc->frame_size, h265, bc->idr || j == 0, j);
+            }
+
+            if (h265 == (encodec == 0 ? 0 : 1))
+            {
+                bench_alloc(bc, data[0], frames); // 与编码方式无关，只测试一次
+            }
+            bench_pipeline(bc, data, frames, h265, FALSE);
+            bench_pipeline(bc, data, frames, h265, TRUE);
+            bench_push(bc, data, frames, h265, port, TransportType_E_UDP);
+            bench_push(bc, data, frames, h265, port, TransportType_E_UNIX);
+            bench_push(bc, data, frames, h265, port, TransportType_E_SHM);
+
+            for (int j = 0; j < BENCH_GOP; j++)
+            {
+                g_free(data[j]);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef __FRAME_BUDGET_H
+#define __FRAME_BUDGET_H
+
+#include <stdint.h> // 引入标准整数定义
+
+#define FRAME_BUDGET_BINS 8 // 帧大小直方图的区间数量
+
+// 定义一个结构体，用于统计编码帧大小相对单帧预算的分布
+typedef struct
+{
+	uint32_t budget_bytes;				// 单帧预算（字节）
+	uint32_t count;						// 统计周期内的帧数
+	uint64_t sum_bytes;					// 统计周期内帧大小的累计值（字节）
+	uint32_t max_bytes;					// 统计周期内的最大帧大小（字节）
+	uint32_t over;						// 统计周期内超出预算的帧数
+	uint32_t over_key;					// 统计周期内超出预算的关键帧数
+	uint64_t total_over;				// 运行以来超出预算的帧数
+	uint32_t bins[FRAME_BUDGET_BINS];	// 帧大小直方图，区间为预算的百分比
+} FrameBudgetStats_S;
+
+/**
+ * @brief 解析单帧预算，形如 "12000"（字节）或 "8000:10"（链路速率kbps:目标发送时间ms）
+ *
+ * @details 第二种形式按链路在目标时间内能发送的字节数计算预算：kbps * ms / 8。
+ *
+ * @param arg 配置字符串
+ * @param budget_bytes 输出的单帧预算（字节）
+ *
+ * @return int 返回0表示成功，-1表示参数无效
+ */
+int frame_budget_parse(const char *arg, uint32_t *budget_bytes);
+
+/**
+ * @brief 初始化帧大小统计
+ *
+ * @param stats 帧大小统计
+ * @param budget_bytes 单帧预算（字节）
+ */
+void frame_budget_stats_init(FrameBudgetStats_S *stats, uint32_t budget_bytes);
+
+/**
+ * @brief 记录一帧的大小
+ *
+ * @param stats 帧大小统计
+ * @param size 帧大小（字节）
+ * @param key 是否为关键帧
+ */
+void frame_budget_stats_add(FrameBudgetStats_S *stats, uint32_t size, int key);
+
+/**
+ * @brief 输出帧大小分布和超出预算的计数，并清零统计周期内的数据
+ *
+ * @param stats 帧大小统计
+ */
+void frame_budget_stats_report(FrameBudgetStats_S *stats);
+
+#endif
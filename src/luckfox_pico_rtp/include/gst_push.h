@@ -5,6 +5,12 @@
 #include <gst/gst.h>            // 引入GStreamer核心库
 #include <gst/app/gstappsink.h> // 引入GStreamer应用程序接收器
 #include <gst/app/gstappsrc.h>  // 引入GStreamer应用程序源
+#include "rt_profile.h"         // 引入实时调度配置
+#include "local_transport.h"    // 引入本地传输通道
+#include "param_sets.h"         // 引入参数集缓存
+
+#define GST_PUSH_MAX_STREAMS 4 // 最多同时推送的视频流数量，第0路为主推流
+#define GST_PUSH_DROPPED 1     // gst_push_data() 的返回值，表示推流队列已满，帧被丢弃
 
 // 定义一个结构体，用于获取编码后的视频帧数据
 typedef struct
@@ -28,6 +34,11 @@ typedef struct
     uint16_t host_port;          // 目标主机的端口号
     EncondecType_E encodec_type; // 视频帧的编码类型（H.264或H.265）
     uint64_t fps;                // 帧率（Frames Per Second）
+    uint32_t max_queue_bytes;    // 推流队列最大字节数，0 表示使用 appsrc 默认值且不丢帧
+    const RtProfile_S *rt_profile; // 发送线程的实时调度配置，NULL 表示不修改
+    TransportType_E transport_type; // RTP包的发送方式，默认经 udpsink 发送到 host_ip:host_port
+    const char *transport_path;     // 本地传输通道（Unix/共享内存）对应的套接字路径
+    uint32_t param_sets_interval_ms; // 周期性重复参数集的间隔（毫秒），0 表示只在IDR前插入
 } GstPushInitParameter_S;
 
 /**
@@ -36,9 +47,21 @@ typedef struct
  * @param frame 指向 FrameData_S 结构体的指针，包含视频帧数据
  *
  * 本函数创建一个GStreamer缓冲区，填充视频帧数据，设置时间戳并将缓冲区推送到appsrc元素。
+ * 必要时在帧前插入缓存的参数集（VPS/SPS/PPS）。
  */
 int gst_push_data(FrameData_S *frame);
 
+/**
+ * @brief 获取视频帧并将其推送到指定推流的管道
+ *
+ * @param id 推流编号，需先调用 gst_push_stream_init() 初始化
+ * @param frame 指向 FrameData_S 结构体的指针，包含视频帧数据
+ * @return int 返回0表示成功，返回-1表示失败，返回 GST_PUSH_DROPPED 表示队列已满、帧被丢弃直到下一个随机接入帧
+ *
+ * gst_push_data() 等同于推送到第0路。不同推流可以在不同线程中并发调用。
+ */
+int gst_push_stream_data(uint8_t id, FrameData_S *frame);
+
 /**
  * @brief 初始化GStreamer管道
  *
@@ -49,6 +72,39 @@ int gst_push_data(FrameData_S *frame);
  */
 int gst_push_init(GstPushInitParameter_S *gst_push_init_parameter);
 
+/**
+ * @brief 初始化指定推流的GStreamer管道
+ *
+ * @param id 推流编号，小于 GST_PUSH_MAX_STREAMS，gst_push_init() 等同于初始化第0路
+ * @param gst_push_init_parameter 指向 GstPushInitParameter_S 结构体的指针，包含初始化参数
+ * @return int 返回0表示成功，返回-1表示失败
+ *
+ * 每路推流有独立的管道、目标地址和参数集缓存。本地传输通道（Unix/共享内存）只能用于第0路。
+ */
+int gst_push_stream_init(uint8_t id, GstPushInitParameter_S *gst_push_init_parameter);
+
+/**
+ * @brief 获取推流队列中尚未处理的字节数
+ *
+ * @return uint64_t appsrc 队列中当前的字节数
+ */
+uint64_t gst_push_queue_bytes(void);
+
+/**
+ * @brief 获取指定推流队列中尚未处理的字节数
+ *
+ * @param id 推流编号
+ * @return uint64_t appsrc 队列中当前的字节数
+ */
+uint64_t gst_push_stream_queue_bytes(uint8_t id);
+
+/**
+ * @brief 获取推流队列满时丢弃的帧数（第0路推流）
+ *
+ * @return uint32_t 运行以来丢弃的帧数
+ */
+uint32_t gst_push_dropped_frames(void);
+
 /**
  * @brief 清理和释放GStreamer管道资源
  *
@@ -58,4 +114,12 @@ int gst_push_init(GstPushInitParameter_S *gst_push_init_parameter);
  */
 int gst_push_deinit(void);
 
+/**
+ * @brief 清理和释放指定推流的GStreamer管道资源
+ *
+ * @param id 推流编号
+ * @return int 返回0表示成功
+ */
+int gst_push_stream_deinit(uint8_t id);
+
 #endif //__GST_PUSH_H
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef __LOCAL_TRANSPORT_H
+#define __LOCAL_TRANSPORT_H
+
+#include <stdint.h> // 引入标准整数定义
+
+#define LOCAL_TRANSPORT_BATCH 64 // Unix 数据报模式下一次批量发送的最大包数
+
+// 枚举类型，用于表示RTP包发送到本地消费者（wfb_tx）的方式
+typedef enum
+{
+	TransportType_E_UDP = 0,  // 经 udpsink 发送到回环 UDP 端口
+	TransportType_E_UNIX = 1, // 经 Unix 数据报套接字批量发送
+	TransportType_E_SHM = 2	  // 写入共享内存环形队列，Unix 套接字仅用作门铃
+} TransportType_E;
+
+/**
+ * @brief 解析形如 "udp"、"unix:/path" 或 "shm:/path" 的传输方式
+ *
+ * @param arg 参数字符串
+ * @param type 输出的传输方式
+ * @param path 输出的本地套接字路径，指向 arg 内部
+ *
+ * @return int 返回0表示成功，-1表示参数无效
+ */
+int local_transport_parse(const char *arg, TransportType_E *type, const char **path);
+
+/**
+ * @brief 打开本地传输通道
+ *
+ * @param type 传输方式，TransportType_E_UNIX 或 TransportType_E_SHM
+ * @param path 消费者绑定的 Unix 数据报套接字路径
+ *
+ * @return int 返回0表示成功，-1表示失败
+ */
+int local_transport_open(TransportType_E type, const char *path);
+
+/**
+ * @brief 获取下一个包的写入缓冲区
+ *
+ * @return uint8_t* 可写入最多 SHM_RING_MAX_PACKET 字节的缓冲区，无可用空间时返回NULL（计入丢包）
+ */
+uint8_t *local_transport_reserve(void);
+
+/**
+ * @brief 提交 local_transport_reserve() 获取的缓冲区
+ *
+ * @param len 写入的包长度
+ */
+void local_transport_commit(uint32_t len);
+
+/**
+ * @brief 发送已提交的包：Unix 模式下批量发送，共享内存模式下按需唤醒消费者
+ *
+ * @return int 返回0表示成功，-1表示发送失败
+ */
+int local_transport_flush(void);
+
+/**
+ * @brief 获取并清零发送的包数和丢弃的包数
+ *
+ * @param sent 输出发送的包数
+ * @param dropped 输出丢弃的包数
+ */
+void local_transport_take_stats(uint32_t *sent, uint32_t *dropped);
+
+/**
+ * @brief 关闭本地传输通道
+ */
+void local_transport_close(void);
+
+#endif
@@ -6,20 +6,25 @@
 /**
  * @brief 初始化视频设备
  *
+ * @param devId 视频设备 ID，类型为 uint8_t，与摄像头编号一致
+ *
  * @return int 返回0表示成功，-1表示失败
  */
-int vi_dev_init(void);
+int vi_dev_init(uint8_t devId);
 
 /**
  * @brief 初始化视频通道
  *
+ * @param devId 视频设备 ID，类型为 uint8_t，通道所在的管道 ID 与之相同
  * @param channelId 通道 ID，类型为 uint8_t
  * @param width 通道图像宽度，类型为 uint16_t
  * @param height 通道图像高度，类型为 uint16_t
+ * @param bufCount 缓冲区数量，类型为 uint8_t，0 表示使用默认值 2
+ * @param wrapLine 环形缓冲区行数，类型为 uint16_t，0 表示使用整帧缓冲区
  *
  * @return int 返回0表示成功，其他值表示错误码
  */
-int vi_chn_init(uint8_t channelId, uint16_t width, uint16_t height);
+int vi_chn_init(uint8_t devId, uint8_t channelId, uint16_t width, uint16_t height, uint8_t bufCount, uint16_t wrapLine);
 
 /**
  * @brief 初始化 VPSS（视频前端支撑子系统）组
@@ -42,9 +47,35 @@ int vpss_init(uint8_t VpssChn, uint16_t width, uint16_t height);
  * @param bitrate 编码比特率，类型为 uint8_t
  * @param fps 编码帧率，类型为 uint8_t
  * @param gop 图像组大小，类型为 uint8_t
+ * @param bufSize 码流缓冲区大小，类型为 uint32_t，0 表示使用整帧原始图像大小
+ * @param bufCnt 码流缓冲区数量，类型为 uint8_t，0 表示使用默认值 2
+ * @param wrapLine 与 VI 共享的环形缓冲区行数，类型为 uint16_t，0 表示按整帧接收
+ * @param frameBudget 单帧大小上限（字节），类型为 uint32_t，0 表示使用 AVBR 码率控制
+ *
+ * @return int 返回0表示成功，-1表示环形缓冲区设置失败，此时通道已销毁
+ */
+int venc_init(uint8_t chnId, uint16_t width, uint16_t height, RK_CODEC_ID_E enType, uint8_t bitrate, uint8_t fps, uint8_t gop, uint32_t bufSize, uint8_t bufCnt, uint16_t wrapLine, uint32_t frameBudget);
+
+/**
+ * @brief 设置编码通道的调度优先级和帧率控制
+ *
+ * @param chnId 编码通道 ID，类型为 uint8_t
+ * @param priority 通道优先级，类型为 uint32_t，多个通道共享编码器时数值大的先编码
+ * @param srcFps 输入帧率，类型为 uint8_t
+ * @param dstFps 编码帧率，类型为 uint8_t，小于输入帧率时编码器按比例丢弃输入帧
+ *
+ * @return int 返回0表示成功，其他值表示错误码
+ */
+int venc_set_chn_param(uint8_t chnId, uint32_t priority, uint8_t srcFps, uint8_t dstFps);
+
+/**
+ * @brief 设置编码通道码率控制使用的帧率
+ *
+ * @param chnId 编码通道 ID，类型为 uint8_t
+ * @param fps 实际送入编码器的帧率，类型为 uint8_t，通道参数启用帧率控制时为丢帧后的帧率
  *
  * @return int 返回0表示成功，其他值表示错误码
  */
-int venc_init(uint8_t chnId, uint16_t width, uint16_t height, RK_CODEC_ID_E enType, uint8_t bitrate, uint8_t fps, uint8_t gop);
+int venc_set_rc_frame_rate(uint8_t chnId, uint8_t fps);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef __MEM_BUDGET_H
+#define __MEM_BUDGET_H
+
+#include <stdint.h> // 引入标准整数定义
+
+// 定义一个结构体，用于存储按内存预算计算出的缓冲区配置
+typedef struct
+{
+	uint32_t budget_kb;		 // 总内存预算（KB）
+	uint32_t raw_frame_size; // 单帧原始图像大小（字节）
+	uint32_t peak_frame;	 // 估计的最大编码帧大小（字节）
+	uint16_t wrap_line;		 // VI/VENC 环形缓冲区行数，0 表示整帧缓冲区
+	uint8_t vi_buf_cnt;		 // VI 缓冲区数量
+	uint32_t vi_bytes;		 // VI 缓冲区占用的内存（字节），环形缓冲区模式下只有一个环形缓冲区
+	uint32_t venc_buf_size;	 // VENC 单个码流缓冲区大小（字节）
+	uint8_t venc_buf_cnt;	 // VENC 码流缓冲区数量
+	uint32_t queue_bytes;	 // 推流队列最大字节数
+	uint32_t total_bytes;	 // 预计占用的总内存（字节）
+} MemBudget_S;
+
+// 定义一个结构体，用于存储运行期间观测到的内存使用情况
+typedef struct
+{
+	uint64_t gst_queue_bytes;  // 推流队列中当前的字节数
+	uint32_t gst_dropped;	   // 推流队列满时丢弃的帧数
+	uint32_t peak_frame;	   // 观测到的最大编码帧大小（字节）
+	uint32_t venc_pending_max; // VENC 码流缓冲区中尚未取走的字节数的最大值
+	uint32_t venc_dropped;	   // 编码器内部丢弃的帧数（由帧序号不连续得到）
+} MemUsage_S;
+
+/**
+ * @brief 根据内存预算计算 VI、VENC 缓冲区和推流队列的大小
+ *
+ * @param plan 输出的缓冲区配置
+ * @param budget_kb 总内存预算（KB）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param wrap_line VI/VENC 环形缓冲区行数，0 表示整帧缓冲区
+ * @param bitrate 编码比特率（Mbps），用于在没有历史数据时估计最大编码帧大小
+ * @param peak_frame 历史观测到的最大编码帧大小（字节），0 表示未知
+ *
+ * @return int 返回0表示预算足够，-1表示最小配置也超出预算
+ */
+int mem_budget_plan(MemBudget_S *plan, uint32_t budget_kb, uint16_t width, uint16_t height, uint16_t wrap_line, uint8_t bitrate, uint32_t peak_frame);
+
+/**
+ * @brief 读取保存的最大编码帧大小
+ *
+ * @param path 文件路径
+ *
+ * @return uint32_t 最大编码帧大小（字节），文件不存在时返回0
+ */
+uint32_t mem_budget_load_peak(const char *path);
+
+/**
+ * @brief 保存最大编码帧大小，供下次启动时计算缓冲区大小
+ *
+ * @param path 文件路径
+ * @param peak_frame 最大编码帧大小（字节）
+ */
+void mem_budget_save_peak(const char *path, uint32_t peak_frame);
+
+/**
+ * @brief 分别输出 MPI 内存块、堆和 GStreamer 的内存占用
+ *
+ * @param plan 缓冲区配置
+ * @param usage 运行期间观测到的内存使用情况
+ */
+void mem_budget_report(const MemBudget_S *plan, const MemUsage_S *usage);
+
+#endif
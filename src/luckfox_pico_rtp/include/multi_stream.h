@@ -0,0 +1,90 @@
+#ifndef __MULTI_STREAM_H
+#define __MULTI_STREAM_H
+
+#include <stdint.h>		// 引入标准整数定义
+#include "gst_push.h"	// 引入推流编号和编码类型
+
+#define MULTI_STREAM_MAX (GST_PUSH_MAX_STREAMS - 1) // 主推流之外最多的附加视频流数量
+#define MULTI_STREAM_HOST_LEN 64					// 目标主机地址的最大长度
+
+// 定义一个结构体，用于描述一路附加视频流（一个摄像头的 ISP/VI/VENC/推流链路）
+typedef struct
+{
+	uint8_t cam_id;						   // 摄像头编号，同时作为 ISP 和 VI 设备编号，主推流固定使用0
+	uint16_t width;						   // 图像宽度
+	uint16_t height;					   // 图像高度
+	uint8_t fps;						   // 帧率
+	uint8_t bitrate;					   // 编码比特率（Mbps）
+	uint16_t host_port;					   // 目标端口号
+	char host_ip[MULTI_STREAM_HOST_LEN]; // 目标主机IP地址
+} StreamConfig_S;
+
+/**
+ * @brief 解析形如 "1:1280x720@30:1:5603" 或 "1:1280x720@30:1:5603:192.168.1.2" 的附加视频流配置
+ *
+ * @details 字段依次为摄像头编号、分辨率@帧率、比特率（Mbps）、目标端口和可选的目标主机，未给出主机时使用 default_ip。
+ *
+ * @param arg 配置字符串
+ * @param default_ip 默认目标主机
+ * @param cfg 输出的视频流配置
+ *
+ * @return int 返回0表示成功，-1表示参数无效
+ */
+int multi_stream_parse(const char *arg, const char *default_ip, StreamConfig_S *cfg);
+
+/**
+ * @brief 初始化多路视频流调度
+ *
+ * @param width 主推流图像宽度
+ * @param height 主推流图像高度
+ * @param fps 主推流帧率
+ * @param capacity_mpix 编码器吞吐量（百万像素/秒），调度按此在各路视频流之间分配编码能力
+ */
+void multi_stream_init(uint16_t width, uint16_t height, uint8_t fps, uint32_t capacity_mpix);
+
+/**
+ * @brief 启动一路附加视频流
+ *
+ * @details 附加视频流按启动顺序编号为 1、2...，编号同时用作 VENC 通道和推流编号，先启动的优先级更高。
+ * 链路在独立的线程中以普通调度策略建立和运行，不会抢占主推流的实时线程。
+ *
+ * @param cfg 视频流配置
+ * @param encodec_type 编码类型，与主推流一致
+ * @param param_sets_interval_ms 周期性重复参数集的间隔（毫秒）
+ *
+ * @return int 返回0表示成功，-1表示失败
+ */
+int multi_stream_start(const StreamConfig_S *cfg, EncondecType_E encodec_type, uint32_t param_sets_interval_ms);
+
+/**
+ * @brief 等待已启动的附加视频流完成链路建立
+ *
+ * @details 链路在各自的线程中建立，返回时每路都已开始取流或已失败退出（超时除外）。
+ * 之后再锁定内存，附加视频流的缓冲区才会被锁定。
+ *
+ * @return int 链路已建立的附加视频流数量
+ */
+int multi_stream_wait_ready(void);
+
+/**
+ * @brief 记录主推流的一帧，并根据主推流延迟调整附加视频流的编码帧率
+ *
+ * @details 在主推流的实时线程中调用，只更新目标降频倍数，不调用阻塞的编码通道设置接口，
+ * 由各路附加视频流的线程设置到自己的编码通道。
+ *
+ * @param latency_us 采集到取得码流的延迟（微秒）
+ * @param size 帧大小（字节）
+ */
+void multi_stream_primary_frame(uint64_t latency_us, uint32_t size);
+
+/**
+ * @brief 输出各路视频流的帧率、延迟和编码器占用率，并清零统计周期内的数据
+ */
+void multi_stream_report(void);
+
+/**
+ * @brief 停止全部附加视频流并释放其资源
+ */
+void multi_stream_stop(void);
+
+#endif
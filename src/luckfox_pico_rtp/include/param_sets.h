@@ -0,0 +1,62 @@
+#ifndef __PARAM_SETS_H
+#define __PARAM_SETS_H
+
+#include <stdint.h> // 引入标准整数定义
+#include <stddef.h> // 引入size_t
+
+#define PARAM_SETS_MAX_NAL 256 // 单个参数集NAL单元的最大长度（不含起始码）
+
+#define PARAM_SETS_FRAME_IRAP 0x1	// 帧为随机接入点（H.264 IDR，H.265 IDR/CRA/BLA）
+#define PARAM_SETS_FRAME_PARAMS 0x2 // 帧中已带有该编码所需的全部参数集
+
+// 枚举类型，用于表示缓存的参数集种类
+typedef enum
+{
+	ParamSetType_E_VPS = 0, // 视频参数集，仅H.265
+	ParamSetType_E_SPS = 1, // 序列参数集
+	ParamSetType_E_PPS = 2, // 图像参数集
+	ParamSetType_E_COUNT
+} ParamSetType_E;
+
+// 定义一个结构体，用于缓存编码器最近输出的参数集
+typedef struct
+{
+	int h265;										  // 是否为H.265码流
+	uint8_t nal[ParamSetType_E_COUNT][PARAM_SETS_MAX_NAL]; // 各参数集的NAL单元（不含起始码）
+	uint32_t nal_size[ParamSetType_E_COUNT];			  // 各参数集的长度，0 表示尚未收到
+	uint8_t annexb[ParamSetType_E_COUNT * (PARAM_SETS_MAX_NAL + 4)]; // 带起始码的参数集拼接结果
+	uint32_t annexb_size;								  // 拼接结果的长度，0 表示参数集不完整
+} ParamSets_S;
+
+/**
+ * @brief 初始化参数集缓存
+ *
+ * @param ps 参数集缓存
+ * @param h265 是否为H.265码流
+ */
+void param_sets_init(ParamSets_S *ps, int h265);
+
+/**
+ * @brief 扫描一帧 Annex B 码流开头的非VCL NAL单元，更新参数集缓存
+ *
+ * @details 参数集总是位于帧内第一个条带之前，因此扫描到第一个VCL NAL单元即停止，开销与帧大小无关。
+ *
+ * @param ps 参数集缓存
+ * @param buf 帧数据
+ * @param size 帧大小
+ *
+ * @return int PARAM_SETS_FRAME_* 标志的组合
+ */
+int param_sets_scan(ParamSets_S *ps, const uint8_t *buf, size_t size);
+
+/**
+ * @brief 获取带起始码的完整参数集（H.265为VPS/SPS/PPS，H.264为SPS/PPS）
+ *
+ * @param ps 参数集缓存
+ * @param size 输出的数据长度
+ *
+ * @return const uint8_t* 参数集数据，参数集尚不完整时返回NULL
+ */
+const uint8_t *param_sets_get(const ParamSets_S *ps, uint32_t *size);
+
+#endif
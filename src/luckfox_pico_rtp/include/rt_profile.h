@@ -0,0 +1,78 @@
+#ifndef __RT_PROFILE_H
+#define __RT_PROFILE_H
+
+#include <stdint.h> // 引入标准整数定义
+
+#define JITTER_BINS 8 // 帧间隔抖动直方图的区间数量
+
+// 定义一个结构体，用于描述实时调度配置
+typedef struct
+{
+	int policy;	  // 调度策略：SCHED_OTHER、SCHED_FIFO 或 SCHED_RR
+	int priority; // 实时优先级，SCHED_OTHER 时为0
+	int cpu;	  // 绑定的CPU编号，-1 表示不绑定
+} RtProfile_S;
+
+// 定义一个结构体，用于统计帧间隔抖动（实际间隔与 1/fps 的偏差）
+typedef struct
+{
+	uint32_t expected_us;			// 期望的帧间隔（微秒）
+	uint64_t last_us;				// 上一帧的时间（微秒），0 表示尚无数据
+	uint32_t count;					// 统计周期内的帧间隔数量
+	uint64_t sum_us;				// 统计周期内偏差绝对值的累计值（微秒）
+	uint32_t max_us;				// 统计周期内偏差绝对值的最大值（微秒）
+	uint32_t bins[JITTER_BINS];		// 偏差直方图
+} JitterStats_S;
+
+/**
+ * @brief 解析形如 "fifo:50"、"rr:10" 或 "other" 的调度配置
+ *
+ * @param arg 配置字符串
+ * @param profile 输出的调度配置，cpu 字段不修改
+ *
+ * @return int 返回0表示成功，-1表示参数无效
+ */
+int rt_profile_parse(const char *arg, RtProfile_S *profile);
+
+/**
+ * @brief 将调度策略、优先级和CPU绑定应用到当前线程
+ *
+ * @param profile 调度配置
+ *
+ * @return int 返回0表示成功，-1表示失败
+ */
+int rt_profile_apply_thread(const RtProfile_S *profile);
+
+/**
+ * @brief 锁定进程已映射的内存，避免热路径上发生缺页
+ *
+ * @details 只锁定调用时已有的映射，且在访问到时才锁定；之后新建的映射不锁定。应在所有链路建立后调用。
+ *
+ * @return int 返回0表示成功，-1表示失败
+ */
+int rt_profile_lock_memory(void);
+
+/**
+ * @brief 初始化帧间隔抖动统计
+ *
+ * @param stats 抖动统计
+ * @param fps 帧率
+ */
+void jitter_stats_init(JitterStats_S *stats, uint8_t fps);
+
+/**
+ * @brief 记录一帧的到达时间
+ *
+ * @param stats 抖动统计
+ * @param now_us 当前时间（微秒）
+ */
+void jitter_stats_add(JitterStats_S *stats, uint64_t now_us);
+
+/**
+ * @brief 输出抖动直方图并清零统计周期内的数据
+ *
+ * @param stats 抖动统计
+ */
+void jitter_stats_report(JitterStats_S *stats);
+
+#endif
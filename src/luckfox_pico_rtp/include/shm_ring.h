@@ -0,0 +1,214 @@
+#ifndef __SHM_RING_H
+#define __SHM_RING_H
+
+/*
+ * 单生产者单消费者共享内存环形队列，用于在 luckfox_pico_rtp 与 wfb_tx 之间传递 RTP 包。
+ *
+ * 本头文件同时被 luckfox_pico_rtp（C）和打过补丁的 wfb_tx（C++）包含，所有函数均为 static inline。
+ * 共享内存名称由本地套接字路径的文件名派生，该套接字同时用作门铃：消费者在等待数据前置位
+ * consumer_waiting，生产者写入数据后若发现该标志被置位，则向套接字发送一个零长度数据报唤醒消费者。
+ */
+
+#include <stdint.h>		// 引入标准整数定义
+#include <stdio.h>		// 引入snprintf
+#include <string.h>		// 引入字符串处理函数
+#include <fcntl.h>		// 引入O_*常量
+#include <unistd.h>		// 引入ftruncate、close、usleep
+#include <sys/mman.h>	// 引入shm_open、mmap
+#include <sys/stat.h>	// 引入fstat
+
+#define SHM_RING_MAGIC 0x57464252	  // 已初始化标志 "WFBR"
+#define SHM_RING_MAGIC_INIT 0x494e4954 // 正在初始化标志 "INIT"
+#define SHM_RING_SLOT_SIZE 2048		  // 每个槽的大小，需大于RTP包的MTU
+#define SHM_RING_SLOT_COUNT 512		  // 槽的数量，必须为2的幂
+#define SHM_RING_HEADER_SIZE 256	  // 队列头大小，数据区从该偏移开始
+#define SHM_RING_MAX_PACKET (SHM_RING_SLOT_SIZE - sizeof(uint32_t)) // 单个包的最大长度
+
+// 定义一个结构体，用于描述共享内存队列头，生产者和消费者使用的字段分别位于不同的缓存行
+typedef struct
+{
+	uint32_t magic;		 // 初始化标志
+	uint32_t slot_size;	 // 槽大小
+	uint32_t slot_count; // 槽数量
+	uint32_t head __attribute__((aligned(64))); // 写入位置，只由生产者修改
+	uint32_t dropped;							 // 队列满时丢弃的包数，由消费者读取清零
+	uint32_t tail __attribute__((aligned(64))); // 读取位置，只由消费者修改
+	uint32_t consumer_waiting;					 // 消费者是否在等待门铃
+} ShmRingHeader_S;
+
+#define SHM_RING_TOTAL_SIZE (SHM_RING_HEADER_SIZE + SHM_RING_SLOT_SIZE * SHM_RING_SLOT_COUNT)
+
+/**
+ * @brief 获取指定序号的槽
+ */
+static inline uint8_t *shm_ring_slot(ShmRingHeader_S *ring, uint32_t index)
+{
+	return (uint8_t *)ring + SHM_RING_HEADER_SIZE + (index & (SHM_RING_SLOT_COUNT - 1)) * SHM_RING_SLOT_SIZE;
+}
+
+/**
+ * @brief 打开（必要时创建并初始化）与本地套接字路径对应的共享内存队列
+ *
+ * @param path 本地套接字路径，共享内存名称为 "/" 加上路径的文件名
+ *
+ * @return ShmRingHeader_S* 返回映射后的队列，失败返回NULL
+ */
+static inline ShmRingHeader_S *shm_ring_open(const char *path)
+{
+	char name[64];				 // 共享内存名称
+	const char *base = strrchr(path, '/'); // 路径中的文件名
+	struct stat st;				 // 共享内存文件状态
+
+	snprintf(name, sizeof(name), "/%s", base ? base + 1 : path);
+	int fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+	if (fd < 0)
+	{
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0 || (st.st_size < (off_t)SHM_RING_TOTAL_SIZE && ftruncate(fd, SHM_RING_TOTAL_SIZE) != 0))
+	{
+		close(fd);
+		return NULL;
+	}
+	void *addr = mmap(NULL, SHM_RING_TOTAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	// 首个打开者负责初始化，其他打开者等待初始化完成
+	ShmRingHeader_S *ring = (ShmRingHeader_S *)addr;
+	uint32_t expected = 0;
+	if (__atomic_compare_exchange_n(&ring->magic, &expected, SHM_RING_MAGIC_INIT, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+	{
+		ring->slot_size = SHM_RING_SLOT_SIZE;
+		ring->slot_count = SHM_RING_SLOT_COUNT;
+		ring->head = 0;
+		ring->tail = 0;
+		ring->dropped = 0;
+		ring->consumer_waiting = 0;
+		__atomic_store_n(&ring->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+	}
+	for (int i = 0; i < 1000 && __atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC; i++)
+	{
+		usleep(1000);
+	}
+	if (ring->magic != SHM_RING_MAGIC || ring->slot_size != SHM_RING_SLOT_SIZE || ring->slot_count != SHM_RING_SLOT_COUNT)
+	{
+		munmap(addr, SHM_RING_TOTAL_SIZE);
+		return NULL;
+	}
+
+	return ring;
+}
+
+/**
+ * @brief 解除共享内存队列的映射
+ */
+static inline void shm_ring_close(ShmRingHeader_S *ring)
+{
+	munmap(ring, SHM_RING_TOTAL_SIZE);
+}
+
+/**
+ * @brief 生产者：获取下一个可写槽的数据区
+ *
+ * @return uint8_t* 可写入最多 SHM_RING_MAX_PACKET 字节的数据区，队列满时返回NULL并计入丢包
+ */
+static inline uint8_t *shm_ring_reserve(ShmRingHeader_S *ring)
+{
+	uint32_t head = ring->head;
+	if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= SHM_RING_SLOT_COUNT)
+	{
+		__atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	return shm_ring_slot(ring, head) + sizeof(uint32_t);
+}
+
+/**
+ * @brief 生产者：提交 shm_ring_reserve() 获取的槽
+ *
+ * @param len 写入的数据长度
+ */
+static inline void shm_ring_commit(ShmRingHeader_S *ring, uint32_t len)
+{
+	uint32_t head = ring->head;
+	memcpy(shm_ring_slot(ring, head), &len, sizeof(len));
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief 生产者：判断是否需要发送门铃唤醒消费者，并清除等待标志
+ *
+ * @return int 返回1表示消费者正在等待
+ */
+static inline int shm_ring_need_doorbell(ShmRingHeader_S *ring)
+{
+	return __atomic_exchange_n(&ring->consumer_waiting, 0, __ATOMIC_SEQ_CST) != 0;
+}
+
+/**
+ * @brief 消费者：获取下一个待读取的包
+ *
+ * @param len 输出包的长度
+ *
+ * @return uint8_t* 包数据，队列为空时返回NULL
+ */
+static inline uint8_t *shm_ring_peek(ShmRingHeader_S *ring, uint32_t *len)
+{
+	uint32_t tail = ring->tail;
+	if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE))
+	{
+		return NULL;
+	}
+
+	uint8_t *slot = shm_ring_slot(ring, tail);
+	memcpy(len, slot, sizeof(*len));
+	if (*len > SHM_RING_MAX_PACKET)
+	{
+		*len = SHM_RING_MAX_PACKET;
+	}
+
+	return slot + sizeof(uint32_t);
+}
+
+/**
+ * @brief 消费者：释放 shm_ring_peek() 返回的包
+ */
+static inline void shm_ring_release(ShmRingHeader_S *ring)
+{
+	__atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 消费者：在等待门铃前置位等待标志
+ *
+ * @return int 返回1表示置位后队列中仍有数据，不应进入等待
+ */
+static inline int shm_ring_arm(ShmRingHeader_S *ring)
+{
+	__atomic_store_n(&ring->consumer_waiting, 1, __ATOMIC_SEQ_CST);
+	return __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) != ring->tail;
+}
+
+/**
+ * @brief 消费者：丢弃队列中的旧数据，通常在消费者启动时调用
+ */
+static inline void shm_ring_reset(ShmRingHeader_S *ring)
+{
+	__atomic_store_n(&ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+	__atomic_store_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 消费者：读取并清零生产者因队列满而丢弃的包数
+ */
+static inline uint32_t shm_ring_take_dropped(ShmRingHeader_S *ring)
+{
+	return __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+}
+
+#endif
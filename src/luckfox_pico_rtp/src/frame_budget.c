@@ -0,0 +1,118 @@
+#include <stdio.h>		  // 引入标准输入输出库，支持打印功能
+#include <stdlib.h>		  // 引入strtoull
+#include <string.h>		  // 引入memset
+#include "frame_budget.h" // 引入单帧预算统计的声明
+
+// 帧大小直方图各区间的上限（预算的百分比），最后一个区间为超过上一个上限的所有值
+static const uint32_t frame_budget_bin_limits[FRAME_BUDGET_BINS - 1] = {25, 50, 75, 90, 100, 125, 150};
+
+/**
+ * @brief 解析单帧预算，形如 "12000"（字节）或 "8000:10"（链路速率kbps:目标发送时间ms）
+ */
+int frame_budget_parse(const char *arg, uint32_t *budget_bytes)
+{
+	char *end;								  // 解析结束位置
+	uint64_t value = strtoull(arg, &end, 10); // 字节数或链路速率，按64位解析，32位平台上unsigned long会截断
+
+	if (end == arg)
+	{
+		return -1;
+	}
+
+	if (*end == ':')
+	{
+		const char *ms_arg = end + 1;				 // 目标发送时间
+		uint64_t ms = strtoull(ms_arg, &end, 10); // 目标发送时间（毫秒）
+		if (end == ms_arg || *end != '\0')
+		{
+			return -1;
+		}
+		// 乘积溢出时拒绝，不能让回绕后的小值通过下面的范围检查
+		if (ms != 0 && value > UINT64_MAX / ms)
+		{
+			return -1;
+		}
+		value = value * ms / 8; // kbps * ms = bit
+	}
+	else if (*end != '\0')
+	{
+		return -1;
+	}
+
+	if (value == 0 || value > UINT32_MAX / 8)
+	{
+		return -1;
+	}
+
+	*budget_bytes = (uint32_t)value;
+	return 0;
+}
+
+/**
+ * @brief 初始化帧大小统计
+ */
+void frame_budget_stats_init(FrameBudgetStats_S *stats, uint32_t budget_bytes)
+{
+	memset(stats, 0, sizeof(FrameBudgetStats_S)); // 清零统计结构体
+	stats->budget_bytes = budget_bytes;			  // 单帧预算
+}
+
+/**
+ * @brief 记录一帧的大小
+ */
+void frame_budget_stats_add(FrameBudgetStats_S *stats, uint32_t size, int key)
+{
+	uint32_t percent = (uint32_t)((uint64_t)size * 100 / stats->budget_bytes); // 帧大小占预算的百分比
+	int bin = 0;																  // 直方图区间
+
+	while (bin < FRAME_BUDGET_BINS - 1 && percent >= frame_budget_bin_limits[bin])
+	{
+		bin++;
+	}
+	stats->bins[bin]++;
+	stats->count++;
+	stats->sum_bytes += size;
+	if (size > stats->max_bytes)
+	{
+		stats->max_bytes = size;
+	}
+	if (size > stats->budget_bytes)
+	{
+		stats->over++;
+		stats->total_over++;
+		if (key)
+		{
+			stats->over_key++;
+		}
+	}
+}
+
+/**
+ * @brief 输出帧大小分布和超出预算的计数，并清零统计周期内的数据
+ */
+void frame_budget_stats_report(FrameBudgetStats_S *stats)
+{
+	if (stats->count == 0)
+	{
+		return;
+	}
+
+	printf("frame size budget=%uB frames=%u avg=%lluB max=%uB(%u%%) over=%u(key %u) total_over=%llu\n",
+		   stats->budget_bytes, stats->count, (unsigned long long)(stats->sum_bytes / stats->count), stats->max_bytes,
+		   (uint32_t)((uint64_t)stats->max_bytes * 100 / stats->budget_bytes), stats->over, stats->over_key,
+		   (unsigned long long)stats->total_over);
+	printf("frame size histogram:");
+	for (int i = 0; i < FRAME_BUDGET_BINS - 1; i++)
+	{
+		printf(" <%u%%:%u", frame_budget_bin_limits[i], stats->bins[i]);
+	}
+	printf(" >=%u%%:%u\n", frame_budget_bin_limits[FRAME_BUDGET_BINS - 2], stats->bins[FRAME_BUDGET_BINS - 1]);
+
+	// 清零统计周期内的数据，保留运行以来的超预算计数
+	stats->count = 0;
+	stats->sum_bytes = 0;
+	stats->max_bytes = 0;
+	stats->over = 0;
+	stats->over_key = 0;
+	memset(stats->bins, 0, sizeof(stats->bins));
+}
@@ -1,43 +1,107 @@
 #include <stdio.h>
+#include <string.h>
 
 #include "gst_push.h"
+#include "shm_ring.h"
 
-// GstElement *pipeline, *appsrc, *parser, *rtp_payloader, *udpsink, *queue; // 定义GStreamer元素的指针
-GstElement *pipeline, *appsrc, *parser, *rtp_payloader, *udpsink; // 定义GStreamer元素的指针
-guint64 fps_time = 0;                                             // 定义用于存储每帧持续时间的变量
-GstBuffer *buffer;                                                // 定义GStreamer缓冲区的指针
-GstFlowReturn ret;                                                // 定义用于存储GStreamer流处理返回值的变量
+#define GST_PUSH_EOS_TIMEOUT (2 * GST_SECOND) // 释放管道时等待EOS的最长时间
+
+// 定义一个结构体，用于存储一路推流的GStreamer管道和状态
+typedef struct
+{
+    // GstElement *pipeline, *appsrc, *parser, *rtp_payloader, *udpsink, *queue; // 定义GStreamer元素的指针
+    GstElement *pipeline, *appsrc, *parser, *rtp_payloader, *sink; // 定义GStreamer元素的指针，sink为udpsink或appsink
+    guint64 fps_time;                                              // 每帧持续时间
+    RtProfile_S send_rt_profile;                                   // 发送线程的实时调度配置
+    TransportType_E transport;                                     // RTP包的发送方式
+    ParamSets_S param_sets;                                        // 编码器最近输出的参数集
+    gint64 param_sets_interval_us;                                 // 周期性重复参数集的间隔（微秒），0 表示只在IDR前插入
+    gint64 param_sets_last_us;                                     // 上一次发送参数集的时间
+    guint64 max_queue_bytes;                                       // 推流队列最大字节数，0 表示不限制
+    gboolean dropping;                                             // 是否正在丢弃帧，直到下一个随机接入帧
+    uint32_t dropped;                                              // 队列满时丢弃的帧数
+} GstPushStream_S;
+
+static GstPushStream_S push_streams[GST_PUSH_MAX_STREAMS]; // 各路推流
 
 /**
- * @brief 获取视频帧并将其推送到管道
+ * @brief 获取视频帧并将其推送到指定推流的管道
  *
+ * @param id 推流编号
  * @param frame 指向 FrameData_S 结构体的指针，包含视频帧数据
  *
- * @return int 返回0表示成功，返回-1表示失败
+ * @return int 返回0表示成功，返回-1表示失败，返回 GST_PUSH_DROPPED 表示帧被丢弃
  *
  * 本函数创建一个GStreamer缓冲区，填充视频帧数据，设置时间戳并将缓冲区推送到appsrc元素。
+ * 随机接入帧不带参数集时，或距上次发送参数集超过设定间隔时，在帧前插入缓存的参数集，
+ * 使中途加入或链路中断后恢复的接收端能尽快开始解码。
+ * 推流队列放不下当前帧时，丢弃当前帧及其后直到下一个随机接入帧的所有帧，避免接收端引用缺失的帧而花屏。
  */
-int gst_push_data(FrameData_S *frame)
+int gst_push_stream_data(uint8_t id, FrameData_S *frame)
 {
+    GstPushStream_S *stream = &push_streams[id]; // 当前推流
+    GstBuffer *buffer;                           // GStreamer缓冲区
+    GstFlowReturn ret;                           // GStreamer流处理返回值
+
+    // 更新参数集缓存，判断是否需要在帧前插入参数集
+    int frame_flags = param_sets_scan(&stream->param_sets, frame->buffer, frame->size); // 帧标志
+
+    // 队列满时按GOP丢帧：开始丢弃后，只有能放入队列的随机接入帧才能结束丢弃
+    if (stream->max_queue_bytes > 0)
+    {
+        guint64 level = 0; // 队列中的字节数
+        g_object_get(stream->appsrc, "current-level-bytes", &level, NULL);
+        if (level > 0 && level + frame->size > stream->max_queue_bytes) // 队列为空时总是接收，避免超大帧导致一直丢弃
+        {
+            stream->dropping = TRUE;
+        }
+        else if (stream->dropping && (frame_flags & PARAM_SETS_FRAME_IRAP))
+        {
+            stream->dropping = FALSE;
+        }
+        if (stream->dropping)
+        {
+            stream->dropped++;
+            return GST_PUSH_DROPPED; // 由调用者请求编码器尽快输出IDR帧
+        }
+    }
+
+    gint64 now = g_get_monotonic_time();                                              // 当前时间
+    const uint8_t *prefix = NULL;                                                      // 插入到帧前的参数集
+    uint32_t prefix_size = 0;                                                          // 插入的参数集长度
+    if (!(frame_flags & PARAM_SETS_FRAME_PARAMS) &&
+        ((frame_flags & PARAM_SETS_FRAME_IRAP) || (stream->param_sets_interval_us > 0 && now - stream->param_sets_last_us >= stream->param_sets_interval_us)))
+    {
+        prefix = param_sets_get(&stream->param_sets, &prefix_size);
+    }
+    if ((frame_flags & PARAM_SETS_FRAME_PARAMS) || prefix != NULL)
+    {
+        stream->param_sets_last_us = now;
+    }
+
     // 创建GStreamer的缓冲区，分配足够的内存以容纳帧数据
-    buffer = gst_buffer_new_allocate(NULL, frame->size, NULL); // 根据帧数据大小分配缓冲区
-    if (buffer == NULL)                                        // 检查缓冲区是否成功创建
+    buffer = gst_buffer_new_allocate(NULL, prefix_size + frame->size, NULL); // 根据帧数据大小分配缓冲区
+    if (buffer == NULL)                                                      // 检查缓冲区是否成功创建
     {
         g_printerr("Failed to create buffer.\n"); // 打印错误信息
         return -1;                                // 返回失败状态
     }
 
     // 填充视频帧数据到缓冲区
-    gst_buffer_fill(buffer, 0, frame->buffer, frame->size); // 将帧数据拷贝到新创建的缓冲区中
+    if (prefix != NULL)
+    {
+        gst_buffer_fill(buffer, 0, prefix, prefix_size); // 先填充参数集
+    }
+    gst_buffer_fill(buffer, prefix_size, frame->buffer, frame->size); // 将帧数据拷贝到新创建的缓冲区中
 
     // 设置PTS（Presentation Timestamp）
     GST_BUFFER_PTS(buffer) = frame->pts; // 设置缓冲区的时间戳为帧数据的时间戳
 
     // 设置每帧的持续时间
-    GST_BUFFER_DURATION(buffer) = fps_time; // 根据帧持续时间设置缓冲区的持续时间
+    GST_BUFFER_DURATION(buffer) = stream->fps_time; // 根据帧持续时间设置缓冲区的持续时间
 
     // 推送缓冲区到appsrc
-    g_signal_emit_by_name(appsrc, "push-buffer", buffer, &ret); // 通过GStreamer信号将缓冲区推送到appsrc元素
+    g_signal_emit_by_name(stream->appsrc, "push-buffer", buffer, &ret); // 通过GStreamer信号将缓冲区推送到appsrc元素
     if (ret != GST_FLOW_OK)                                     // 检查推送是否成功
     {
         g_printerr("Error pushing buffer to appsrc: %d\n", ret); // 打印错误信息
@@ -51,36 +115,206 @@ int gst_push_data(FrameData_S *frame)
 }
 
 /**
- * @brief 初始化GStreamer管道
+ * @brief 获取视频帧并将其推送到管道（第0路推流）
+ */
+int gst_push_data(FrameData_S *frame)
+{
+    return gst_push_stream_data(0, frame);
+}
+
+/**
+ * @brief 将一个RTP包拷贝到本地传输通道
+ *
+ * @param rtp_buffer RTP包缓冲区
+ */
+static void gst_push_send_packet(GstBuffer *rtp_buffer)
+{
+    gsize size = gst_buffer_get_size(rtp_buffer); // RTP包大小
+    if (size > SHM_RING_MAX_PACKET)
+    {
+        g_printerr("RTP packet too large: %" G_GSIZE_FORMAT "\n", size); // 超过槽大小，丢弃
+        return;
+    }
+
+    uint8_t *dst = local_transport_reserve(); // 获取写入位置（共享内存槽或批量发送缓冲区）
+    if (dst == NULL)
+    {
+        return; // 无可用空间，已计入丢包
+    }
+    gst_buffer_extract(rtp_buffer, 0, dst, size); // 直接拷贝到目标位置，只有一次拷贝
+    local_transport_commit(size);
+}
+
+/**
+ * @brief appsink 新数据回调，在发送线程中把RTP包交给本地消费者
+ *
+ * @details RTP打包器一次输出一帧的所有包（缓冲区列表），全部写入后再统一发送或唤醒消费者。
+ */
+static GstFlowReturn gst_push_new_sample(GstAppSink *appsink, gpointer user_data)
+{
+    GstSample *sample = gst_app_sink_pull_sample(appsink); // 取出数据
+    if (sample == NULL)
+    {
+        return GST_FLOW_EOS;
+    }
+
+    GstBufferList *list = gst_sample_get_buffer_list(sample); // 缓冲区列表
+    if (list != NULL)
+    {
+        guint length = gst_buffer_list_length(list);
+        for (guint i = 0; i < length; i++)
+        {
+            gst_push_send_packet(gst_buffer_list_get(list, i));
+        }
+    }
+    else
+    {
+        gst_push_send_packet(gst_sample_get_buffer(sample));
+    }
+    local_transport_flush(); // 批量发送或按需唤醒消费者
+
+    gst_sample_unref(sample);
+    return GST_FLOW_OK;
+}
+
+/**
+ * @brief 总线同步处理函数，在GStreamer流线程启动时应用实时调度配置
  *
+ * @details STREAM_STATUS ENTER 消息由新创建的流线程自身同步发出，因此可以直接设置当前线程。
+ * appsrc 的流线程负责解析、RTP打包和UDP发送，即发送线程。
+ */
+static GstBusSyncReply gst_push_bus_sync_handler(GstBus *bus, GstMessage *msg, gpointer user_data)
+{
+    if (GST_MESSAGE_TYPE(msg) != GST_MESSAGE_STREAM_STATUS)
+    {
+        return GST_BUS_PASS; // 其他消息交给总线队列处理
+    }
+
+    GstStreamStatusType type; // 流状态类型
+    GstElement *owner;        // 流线程所属的元素
+    GstPushStream_S *stream = (GstPushStream_S *)user_data; // 当前推流
+    gst_message_parse_stream_status(msg, &type, &owner);
+    if (type == GST_STREAM_STATUS_TYPE_ENTER)
+    {
+        if (rt_profile_apply_thread(&stream->send_rt_profile) == 0)
+        {
+            g_print("Applied rt profile to %s streaming thread.\n", GST_ELEMENT_NAME(owner)); // 打印已设置的流线程
+        }
+        else
+        {
+            g_printerr("Failed to apply rt profile to %s streaming thread.\n", GST_ELEMENT_NAME(owner)); // 打印设置失败的流线程
+        }
+    }
+
+    gst_message_unref(msg); // 流状态消息无需再进入总线队列
+    return GST_BUS_DROP;
+}
+
+/**
+ * @brief 初始化失败时释放已创建的管道和本地传输通道
+ *
+ * @param stream 推流
+ * @return int 总是返回-1，便于在错误路径上直接返回
+ *
+ * 元素加入管道后由管道持有，释放管道即释放所有元素。清空管道指针，使 gst_push_stream_deinit() 不会向未启动的管道发送EOS。
+ */
+static int gst_push_stream_fail(GstPushStream_S *stream)
+{
+    if (stream->pipeline != NULL)
+    {
+        gst_element_set_state(stream->pipeline, GST_STATE_NULL); // 将管道状态设置为NULL，以释放资源
+        gst_object_unref(stream->pipeline);                      // 释放管道及其中的元素
+        stream->pipeline = NULL;
+    }
+    stream->appsrc = NULL;
+    stream->parser = NULL;
+    stream->rtp_payloader = NULL;
+    stream->sink = NULL;
+
+    if (stream->transport != TransportType_E_UDP)
+    {
+        local_transport_close(); // 关闭本地传输通道，未打开时无副作用
+    }
+
+    return -1;
+}
+
+/**
+ * @brief 初始化指定推流的GStreamer管道
+ *
+ * @param id 推流编号，0 为主推流
  * @param gst_push_init_parameter 指向 GstPushInitParameter_S 结构体的指针，包含初始化参数
  * @return int 返回0表示成功，返回-1表示失败
  *
  * 本函数初始化GStreamer，创建所需的GStreamer元素，链接它们并设置属性。还会根据传入的帧率计算每帧的持续时间。
+ * 管道的流线程由调用线程在启动管道时创建，因此会继承调用线程的调度策略。
  */
-int gst_push_init(GstPushInitParameter_S *gst_push_init_parameter)
+int gst_push_stream_init(uint8_t id, GstPushInitParameter_S *gst_push_init_parameter)
 {
+    if (id >= GST_PUSH_MAX_STREAMS)
+    {
+        g_printerr("Stream id %u out of range.\n", id); // 打印错误信息
+        return -1;                                      // 返回失败状态
+    }
+    if (id != 0 && gst_push_init_parameter->transport_type != TransportType_E_UDP)
+    {
+        g_printerr("Local transport is only supported on stream 0.\n"); // 本地传输通道只有一个，仅供主推流使用
+        return -1;                                                      // 返回失败状态
+    }
+
+    GstPushStream_S *stream = &push_streams[id]; // 当前推流
+    memset(stream, 0, sizeof(GstPushStream_S));  // 清零推流状态
+
     // 初始化GStreamer
-    gst_init(NULL, NULL); // 初始化GStreamer库，以便使用其功能
+    gst_init(NULL, NULL); // 初始化GStreamer库，以便使用其功能，多次调用无副作用
 
-    // 创建GStreamer元素
-    appsrc = gst_element_factory_make("appsrc", "source");                                                                          // 创建应用程序源元素appsrc
-    parser = gst_element_factory_make(gst_push_init_parameter->encodec_type ? "h265parse" : "h264parse", "parser");                 // 根据编码类型选择解析器
-    rtp_payloader = gst_element_factory_make(gst_push_init_parameter->encodec_type ? "rtph265pay" : "rtph264pay", "rtp_payloader"); // 根据编码类型选择RTP打包元素
-    udpsink = gst_element_factory_make("udpsink", "udp_sink");                                                                      // 创建UDP接收器元素
+    // 创建GStreamer元素，元素名在各自的管道内唯一即可
+    stream->appsrc = gst_element_factory_make("appsrc", "source");                                                                          // 创建应用程序源元素appsrc
+    stream->parser = gst_element_factory_make(gst_push_init_parameter->encodec_type ? "h265parse" : "h264parse", "parser");                 // 根据编码类型选择解析器
+    stream->rtp_payloader = gst_element_factory_make(gst_push_init_parameter->encodec_type ? "rtph265pay" : "rtph264pay", "rtp_payloader"); // 根据编码类型选择RTP打包元素
+    stream->transport = gst_push_init_parameter->transport_type;                                                                            // 记录RTP包的发送方式
+    param_sets_init(&stream->param_sets, gst_push_init_parameter->encodec_type == EncondecType_E_H265);                                     // 清空参数集缓存
+    stream->param_sets_interval_us = (gint64)gst_push_init_parameter->param_sets_interval_ms * 1000;                                        // 周期性重复参数集的间隔
+    stream->param_sets_last_us = 0;
+    if (stream->transport == TransportType_E_UDP)
+    {
+        stream->sink = gst_element_factory_make("udpsink", "udp_sink"); // 创建UDP接收器元素
+    }
+    else
+    {
+        stream->sink = gst_element_factory_make("appsink", "app_sink"); // 创建应用程序接收器元素，由本模块把RTP包交给本地消费者
+    }
     // queue = gst_element_factory_make("queue", "queue");                                                                             // 创建队列元素
 
     // 创建一个新的GStreamer管道
-    pipeline = gst_pipeline_new("video-pipeline"); // 创建新的GStreamer管道
+    gchar *pipeline_name = g_strdup_printf("video-pipeline-%u", id); // 管道名称
+    stream->pipeline = gst_pipeline_new(pipeline_name);               // 创建新的GStreamer管道
+    g_free(pipeline_name);
+
+    GstElement *pipeline = stream->pipeline, *appsrc = stream->appsrc, *parser = stream->parser; // 以下使用局部名称，便于阅读
+    GstElement *rtp_payloader = stream->rtp_payloader, *sink = stream->sink;
 
     // 检查所有元素是否成功创建，任何失败都打印相应的错误信息并退出
     // if (!pipeline || !appsrc || !parser || !rtp_payloader || !udpsink || !queue)
-    if (!pipeline || !appsrc || !parser || !rtp_payloader || !udpsink)
+    if (!pipeline || !appsrc || !parser || !rtp_payloader || !sink)
     {
         g_printerr("Failed to create one or more GStreamer elements. Exiting.\n"); // 打印错误信息
-        return -1;                                                                 // 返回失败状态
+        // 尚未加入管道的元素需要单独释放
+        GstElement *elements[] = {appsrc, parser, rtp_payloader, sink};
+        for (size_t i = 0; i < sizeof(elements) / sizeof(elements[0]); i++)
+        {
+            if (elements[i] != NULL)
+            {
+                gst_object_unref(gst_object_ref_sink(elements[i]));
+            }
+        }
+        return gst_push_stream_fail(stream); // 返回失败状态
     }
 
+    // 将所有创建的元素添加到管道中，之后由管道持有
+    // gst_bin_add_many(GST_BIN(pipeline), appsrc, parser, queue, rtp_payloader, udpsink, NULL); // 添加元素到管道
+    gst_bin_add_many(GST_BIN(pipeline), appsrc, parser, rtp_payloader, sink, NULL); // 添加元素到管道
+
     // 设置appsrc元素的属性，以支持实时数据流
     GstCaps *caps = gst_caps_new_simple(gst_push_init_parameter->encodec_type ? "video/x-h265" : "video/x-h264", 
                                         "stream-format", G_TYPE_STRING, "byte-stream", 
@@ -91,69 +325,152 @@ int gst_push_init(GstPushInitParameter_S *gst_push_init_parameter)
     g_object_set(appsrc, "is-live", TRUE, NULL);           // 指定appsrc是一个实时数据源
     g_object_set(appsrc, "min-latency", 0, NULL);          // 设置appsrc的最小延迟
     g_object_set(appsrc, "max-latency", 0, NULL);          // 设置appsrc的最大延迟
+    if (gst_push_init_parameter->max_queue_bytes > 0)
+    {
+        // 队列满时由 gst_push_stream_data() 按GOP丢帧，不使用 appsrc 的 leaky-type，以免丢弃队列中的IDR帧
+        stream->max_queue_bytes = gst_push_init_parameter->max_queue_bytes;
+        g_object_set(appsrc, "max-bytes", stream->max_queue_bytes, NULL); // 限制队列最大字节数
+    }
+
+    // 参数集由 gst_push_stream_data() 按需插入，解析器不再重复插入
+    g_object_set(parser, "config-interval", 0, NULL);
+
+    if (stream->transport == TransportType_E_UDP)
+    {
+        // 设置udpsink元素的目标主机和端口
+        g_object_set(sink, "host", gst_push_init_parameter->host_ip, NULL);   // 设置UDP目标主机IP
+        g_object_set(sink, "port", gst_push_init_parameter->host_port, NULL); // 设置UDP目标端口
+    }
+    else
+    {
+        // 打开本地传输通道，并设置appsink以缓冲区列表的形式同步回调
+        if (local_transport_open(stream->transport, gst_push_init_parameter->transport_path) != 0)
+        {
+            g_printerr("Failed to open local transport %s. Exiting.\n", gst_push_init_parameter->transport_path); // 打印错误信息
+            return gst_push_stream_fail(stream);                                                                    // 返回失败状态
+        }
+        g_object_set(sink, "emit-signals", FALSE, NULL); // 使用回调而非信号
+        if (g_object_class_find_property(G_OBJECT_GET_CLASS(sink), "buffer-list"))
+        {
+            g_object_set(sink, "buffer-list", TRUE, NULL); // 一帧的RTP包一次交付（GStreamer 1.12及以上）
+        }
 
-    // 设置udpsink元素的目标主机和端口
-    g_object_set(udpsink, "host", gst_push_init_parameter->host_ip, NULL);   // 设置UDP目标主机IP
-    g_object_set(udpsink, "port", gst_push_init_parameter->host_port, NULL); // 设置UDP目标端口
-    g_object_set(udpsink, "sync", FALSE, NULL);                              // 设置为不使用同步，立即发送数据
+        GstAppSinkCallbacks callbacks; // appsink回调函数
+        memset(&callbacks, 0, sizeof(callbacks));
+        callbacks.new_sample = gst_push_new_sample;
+        gst_app_sink_set_callbacks(GST_APP_SINK(sink), &callbacks, NULL, NULL);
+    }
+    g_object_set(sink, "sync", FALSE, NULL); // 设置为不使用同步，立即发送数据
 
     // 设置队列的属性
     // g_object_set(queue, "max-size-buffers", 1, NULL); // 设置队列最大缓存1个缓冲区
     // g_object_set(queue, "max-size-bytes", 0, NULL);   // 最大缓存字节数为无限制
     // g_object_set(queue, "max-size-time", 0, NULL);    // 最大缓存时间无限制
 
-    // 将所有创建的元素添加到管道中
-    // gst_bin_add_many(GST_BIN(pipeline), appsrc, parser, queue, rtp_payloader, udpsink, NULL); // 添加元素到管道
-    gst_bin_add_many(GST_BIN(pipeline), appsrc, parser, rtp_payloader, udpsink, NULL); // 添加元素到管道
-
     // 链接管道中的所有元素，如果链接失败则打印错误并退出
     // if (!gst_element_link_many(appsrc, parser, queue, rtp_payloader, udpsink, NULL))
-    if (!gst_element_link_many(appsrc, parser, rtp_payloader, udpsink, NULL))
+    if (!gst_element_link_many(appsrc, parser, rtp_payloader, sink, NULL))
     {
         g_printerr("Elements could not be linked. Exiting.\n"); // 打印错误信息
-        // gst_bin_remove_many(GST_BIN(pipeline), appsrc, parser, queue, rtp_payloader, udpsink, NULL); // 移除已添加的元素
-        gst_bin_remove_many(GST_BIN(pipeline), appsrc, parser, rtp_payloader, udpsink, NULL); // 移除已添加的元素
-        gst_object_unref(pipeline);                                                           // 释放管道资源
-        return -1;                                                                            // 返回失败状态
+        return gst_push_stream_fail(stream);                    // 释放管道资源，返回失败状态
+    }
+
+    // 设置发送线程的实时调度配置，需在启动管道前安装总线同步处理函数
+    if (gst_push_init_parameter->rt_profile != NULL)
+    {
+        stream->send_rt_profile = *gst_push_init_parameter->rt_profile;
+        GstBus *bus = gst_element_get_bus(pipeline);
+        gst_bus_set_sync_handler(bus, gst_push_bus_sync_handler, stream, NULL);
+        gst_object_unref(bus);
     }
 
     // 启动管道，切换到播放状态
-    gst_element_set_state(pipeline, GST_STATE_PLAYING); // 将管道状态设置为播放
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) // 将管道状态设置为播放
+    {
+        g_printerr("Unable to set the pipeline to the playing state.\n"); // 打印错误信息
+        return gst_push_stream_fail(stream);                              // 释放管道资源，返回失败状态
+    }
 
     // 计算帧持续时间
     if (gst_push_init_parameter->fps > 0)
     {                                                                                  // 如果帧率大于0
-        fps_time = gst_util_uint64_scale(GST_SECOND, 1, gst_push_init_parameter->fps); // 根据帧率计算每帧的持续时间
+        stream->fps_time = gst_util_uint64_scale(GST_SECOND, 1, gst_push_init_parameter->fps); // 根据帧率计算每帧的持续时间
     }
     else
     {
-        g_printerr("FPS must be greater than 0.\n");         // 打印错误信息
-        fps_time = gst_util_uint64_scale(GST_SECOND, 1, 30); // 默认帧率为30fps的持续时间
+        g_printerr("FPS must be greater than 0.\n");                 // 打印错误信息
+        stream->fps_time = gst_util_uint64_scale(GST_SECOND, 1, 30); // 默认帧率为30fps的持续时间
     }
 
     return 0; // 返回成功状态
 }
 
 /**
- * @brief 清理和释放GStreamer管道资源
+ * @brief 初始化GStreamer管道（第0路推流）
+ */
+int gst_push_init(GstPushInitParameter_S *gst_push_init_parameter)
+{
+    return gst_push_stream_init(0, gst_push_init_parameter);
+}
+
+/**
+ * @brief 获取指定推流队列中尚未处理的字节数
+ *
+ * @param id 推流编号
+ * @return uint64_t appsrc 队列中当前的字节数
+ */
+uint64_t gst_push_stream_queue_bytes(uint8_t id)
+{
+    guint64 level = 0; // 队列中的字节数
+
+    g_object_get(push_streams[id].appsrc, "current-level-bytes", &level, NULL); // 读取appsrc当前队列字节数
+
+    return level;
+}
+
+/**
+ * @brief 获取推流队列中尚未处理的字节数（第0路推流）
+ */
+uint64_t gst_push_queue_bytes(void)
+{
+    return gst_push_stream_queue_bytes(0);
+}
+
+/**
+ * @brief 获取推流队列满时丢弃的帧数（第0路推流）
+ */
+uint32_t gst_push_dropped_frames(void)
+{
+    return push_streams[0].dropped;
+}
+
+/**
+ * @brief 清理和释放指定推流的GStreamer管道资源
  *
+ * @param id 推流编号
  * @return int 返回0表示成功
  *
  * 本函数发送EOS（End Of Stream）信号，处理消息，然后清理管道相关资源。
  */
-int gst_push_deinit(void)
+int gst_push_stream_deinit(uint8_t id)
 {
-    GstBus *bus;     // 定义消息总线变量
-    GstMessage *msg; // 定义消息变量
+    GstPushStream_S *stream = &push_streams[id]; // 当前推流
+    GstBus *bus;                                 // 定义消息总线变量
+    GstMessage *msg;                             // 定义消息变量
+
+    if (stream->pipeline == NULL)
+    {
+        return 0; // 未初始化
+    }
 
     // 发送EOS信号以指示流的结束
-    g_signal_emit_by_name(appsrc, "end-of-stream", NULL); // 发送结束流信号
+    g_signal_emit_by_name(stream->appsrc, "end-of-stream", NULL); // 发送结束流信号
 
     // 获取管道的消息总线
-    bus = gst_element_get_bus(pipeline); // 获取消息总线以便监听消息
+    bus = gst_element_get_bus(stream->pipeline); // 获取消息总线以便监听消息
 
     // 从总线中提取EOS或错误消息
-    msg = gst_bus_timed_pop_filtered(bus, GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR); // 从总线中提取消息
+    msg = gst_bus_timed_pop_filtered(bus, GST_PUSH_EOS_TIMEOUT, GST_MESSAGE_EOS | GST_MESSAGE_ERROR); // 从总线中提取消息，最多等待 GST_PUSH_EOS_TIMEOUT
 
     // 检查是否有消息可处理
     if (msg != NULL) // 如果成功接收到消息
@@ -180,11 +497,29 @@ int gst_push_deinit(void)
 
         gst_message_unref(msg); // 释放消息对象
     }
+    else
+    {
+        g_printerr("End-Of-Stream not reached in time, stopping pipeline.\n"); // 等待超时，直接停止管道
+    }
 
     // 释放所有资源
-    gst_object_unref(bus);                           // 释放总线资源
-    gst_element_set_state(pipeline, GST_STATE_NULL); // 将管道状态设置为NULL，以释放资源
-    gst_object_unref(pipeline);                      // 释放管道资源
+    gst_object_unref(bus);                                   // 释放总线资源
+    gst_element_set_state(stream->pipeline, GST_STATE_NULL); // 将管道状态设置为NULL，以释放资源
+    gst_object_unref(stream->pipeline);                      // 释放管道资源
+    stream->pipeline = NULL;
+
+    if (stream->transport != TransportType_E_UDP)
+    {
+        local_transport_close(); // 关闭本地传输通道
+    }
 
     return 0; // 返回成功状态
+}
+
+/**
+ * @brief 清理和释放GStreamer管道资源（第0路推流）
+ */
+int gst_push_deinit(void)
+{
+    return gst_push_stream_deinit(0);
 }
\ No newline at end of file
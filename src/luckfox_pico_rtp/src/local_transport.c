@@ -0,0 +1,264 @@
+#define _GNU_SOURCE
+#include <stdio.h>			 // 引入标准输入输出库，支持打印功能
+#include <stdlib.h>			 // 引入malloc/free
+#include <string.h>			 // 引入字符串处理库
+#include <errno.h>			 // 引入错误码定义
+#include <unistd.h>			 // 引入close
+#include <poll.h>			 // 引入poll，用于等待消费者接收队列有空间
+#include <time.h>			 // 引入clock_gettime
+#include <sys/socket.h>		 // 引入套接字接口
+#include <sys/un.h>			 // 引入Unix套接字地址定义
+#include "shm_ring.h"		 // 引入共享内存环形队列
+#include "local_transport.h" // 引入本地传输通道的声明
+
+#define LOCAL_TRANSPORT_SEND_TIMEOUT_MS 10 // Unix 模式下消费者接收队列满时，每次批量发送最多等待的时间（毫秒）
+
+static TransportType_E transport_type = TransportType_E_UDP; // 当前传输方式
+static int transport_fd = -1;								  // Unix 数据报套接字（共享内存模式下作为门铃）
+static struct sockaddr_un transport_addr;					  // 消费者的套接字地址
+static ShmRingHeader_S *transport_ring = NULL;				  // 共享内存环形队列
+static uint32_t transport_sent = 0;						  // 发送的包数
+static uint32_t transport_dropped = 0;						  // 丢弃的包数
+
+// Unix 数据报模式下的批量发送缓冲区，只在 Unix 模式打开时分配，避免 UDP/共享内存模式常驻（并被 mlockall 锁定）
+static uint8_t *batch_buf = NULL;									   // 包数据，LOCAL_TRANSPORT_BATCH 个 SHM_RING_MAX_PACKET 大小的槽
+static struct iovec batch_iov[LOCAL_TRANSPORT_BATCH];				   // 每个包的数据描述
+static struct mmsghdr batch_msg[LOCAL_TRANSPORT_BATCH];			   // sendmmsg 的消息数组
+static unsigned int batch_count = 0;								   // 已提交的包数
+
+/**
+ * @brief 解析形如 "udp"、"unix:/path" 或 "shm:/path" 的传输方式
+ */
+int local_transport_parse(const char *arg, TransportType_E *type, const char **path)
+{
+	if (strcmp(arg, "udp") == 0)
+	{
+		*type = TransportType_E_UDP;
+		*path = NULL;
+		return 0;
+	}
+	if (strncmp(arg, "unix:", 5) == 0 && arg[5] != '\0')
+	{
+		*type = TransportType_E_UNIX;
+		*path = arg + 5;
+		return 0;
+	}
+	if (strncmp(arg, "shm:", 4) == 0 && arg[4] != '\0')
+	{
+		*type = TransportType_E_SHM;
+		*path = arg + 4;
+		return 0;
+	}
+
+	return -1;
+}
+
+/**
+ * @brief 连接消费者的 Unix 数据报套接字
+ *
+ * @details 消费者启动前连接会失败；消费者重启后会重新绑定路径，旧连接失效。两种情况都在发送失败时重新连接。
+ */
+static int local_transport_connect(void)
+{
+	return connect(transport_fd, (struct sockaddr *)&transport_addr, sizeof(transport_addr));
+}
+
+/**
+ * @brief 打开本地传输通道
+ */
+int local_transport_open(TransportType_E type, const char *path)
+{
+	transport_type = type;
+	transport_sent = 0;
+	transport_dropped = 0;
+	batch_count = 0;
+
+	memset(&transport_addr, 0, sizeof(transport_addr));
+	transport_addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(transport_addr.sun_path))
+	{
+		printf("local transport path too long: %s\n", path);
+		return -1;
+	}
+	strcpy(transport_addr.sun_path, path);
+
+	transport_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (transport_fd < 0)
+	{
+		printf("create unix socket failed: %s\n", strerror(errno));
+		return -1;
+	}
+	if (local_transport_connect() != 0)
+	{
+		printf("connect %s failed: %s, retry when sending\n", path, strerror(errno)); // 消费者可能尚未启动
+	}
+
+	if (type == TransportType_E_SHM)
+	{
+		transport_ring = shm_ring_open(path);
+		if (transport_ring == NULL)
+		{
+			printf("open shm ring for %s failed: %s\n", path, strerror(errno));
+			close(transport_fd);
+			transport_fd = -1;
+			return -1;
+		}
+	}
+	else
+	{
+		batch_buf = (uint8_t *)malloc((size_t)LOCAL_TRANSPORT_BATCH * SHM_RING_MAX_PACKET);
+		if (batch_buf == NULL)
+		{
+			printf("alloc local transport batch buffer failed\n");
+			close(transport_fd);
+			transport_fd = -1;
+			return -1;
+		}
+
+		// 预先设置批量发送消息数组，每个消息对应一个包缓冲区
+		memset(batch_msg, 0, sizeof(batch_msg));
+		for (int i = 0; i < LOCAL_TRANSPORT_BATCH; i++)
+		{
+			batch_iov[i].iov_base = batch_buf + (size_t)i * SHM_RING_MAX_PACKET;
+			batch_msg[i].msg_hdr.msg_iov = &batch_iov[i];
+			batch_msg[i].msg_hdr.msg_iovlen = 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief 获取下一个包的写入缓冲区
+ */
+uint8_t *local_transport_reserve(void)
+{
+	if (transport_type == TransportType_E_SHM)
+	{
+		uint8_t *slot = shm_ring_reserve(transport_ring);
+		if (slot == NULL)
+		{
+			transport_dropped++; // 队列满，消费者处理不过来
+		}
+		return slot;
+	}
+
+	if (batch_count == LOCAL_TRANSPORT_BATCH)
+	{
+		local_transport_flush(); // 批量缓冲区已满，先发送
+	}
+
+	return batch_buf + (size_t)batch_count * SHM_RING_MAX_PACKET;
+}
+
+/**
+ * @brief 提交 local_transport_reserve() 获取的缓冲区
+ */
+void local_transport_commit(uint32_t len)
+{
+	if (transport_type == TransportType_E_SHM)
+	{
+		shm_ring_commit(transport_ring, len);
+		transport_sent++;
+		return;
+	}
+
+	batch_iov[batch_count].iov_len = len;
+	batch_count++;
+}
+
+/**
+ * @brief 发送已提交的包：Unix 模式下批量发送，共享内存模式下按需唤醒消费者
+ */
+int local_transport_flush(void)
+{
+	if (transport_type == TransportType_E_SHM)
+	{
+		// 只有消费者在等待时才需要系统调用
+		if (shm_ring_need_doorbell(transport_ring) && send(transport_fd, NULL, 0, MSG_DONTWAIT) < 0)
+		{
+			if (errno == ECONNREFUSED || errno == ENOTCONN || errno == EDESTADDRREQ)
+			{
+				local_transport_connect();
+			}
+			return -1;
+		}
+		return 0;
+	}
+
+	unsigned int sent = 0;  // 已发送的包数
+	int64_t deadline_ms = -1; // 等待消费者的截止时间，-1 表示尚未等待
+	while (sent < batch_count)
+	{
+		int ret = sendmmsg(transport_fd, batch_msg + sent, batch_count - sent, MSG_DONTWAIT);
+		if (ret < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				// 消费者接收队列已满（受 net.unix.max_dgram_qlen 限制）：单核上消费者只有在本线程让出CPU后才能取走数据，
+				// 等待队列有空间再继续发送，超过截止时间才丢弃剩余的包，避免一个 IDR 帧的大部分包被丢弃
+				struct timespec now;
+				clock_gettime(CLOCK_MONOTONIC, &now);
+				int64_t now_ms = (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+				if (deadline_ms < 0)
+				{
+					deadline_ms = now_ms + LOCAL_TRANSPORT_SEND_TIMEOUT_MS;
+				}
+				struct pollfd pfd = {transport_fd, POLLOUT, 0};
+				if (now_ms < deadline_ms && poll(&pfd, 1, (int)(deadline_ms - now_ms)) > 0 && (pfd.revents & POLLOUT))
+				{
+					continue;
+				}
+				break; // 等待超时，丢弃剩余的包
+			}
+			if (errno == ECONNREFUSED || errno == ENOTCONN || errno == EDESTADDRREQ)
+			{
+				local_transport_connect();
+			}
+			break; // 消费者未运行，丢弃剩余的包
+		}
+		sent += ret;
+	}
+
+	int ret = sent == batch_count ? 0 : -1; // 是否全部发送成功
+	transport_sent += sent;
+	transport_dropped += batch_count - sent;
+	batch_count = 0;
+
+	return ret;
+}
+
+/**
+ * @brief 获取并清零发送的包数和丢弃的包数
+ */
+void local_transport_take_stats(uint32_t *sent, uint32_t *dropped)
+{
+	*sent = transport_sent;
+	*dropped = transport_dropped;
+	transport_sent = 0;
+	transport_dropped = 0;
+}
+
+/**
+ * @brief 关闭本地传输通道
+ */
+void local_transport_close(void)
+{
+	if (transport_ring != NULL)
+	{
+		shm_ring_close(transport_ring);
+		transport_ring = NULL;
+	}
+	if (transport_fd >= 0)
+	{
+		close(transport_fd);
+		transport_fd = -1;
+	}
+	free(batch_buf);
+	batch_buf = NULL;
+	batch_count = 0;
+}
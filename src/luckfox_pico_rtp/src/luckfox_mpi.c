@@ -4,12 +4,13 @@
 /**
  * @brief 初始化视频设备
  *
+ * @param devId 视频设备 ID，类型为 uint8_t，与摄像头编号一致
+ *
  * @return int 返回0表示成功，-1表示失败
  */
-int vi_dev_init(void)
+int vi_dev_init(uint8_t devId)
 {
 	int ret = 0;		// 初始化返回值
-	int devId = 0;		// 视频设备 ID, 此处固定为 0
 	int pipeId = devId; // 管道 ID 设为同设备 ID
 
 	VI_DEV_ATTR_S stDevAttr;					// 定义视频设备属性结构体
@@ -66,13 +67,16 @@ int vi_dev_init(void)
 /**
  * @brief 初始化视频通道
  *
+ * @param devId 视频设备 ID，类型为 uint8_t，通道所在的管道 ID 与之相同
  * @param channelId 通道 ID，类型为 uint8_t
  * @param width 通道图像宽度，类型为 uint16_t
  * @param height 通道图像高度，类型为 uint16_t
+ * @param bufCount 缓冲区数量，类型为 uint8_t，0 表示使用默认值 2
+ * @param wrapLine 环形缓冲区行数，类型为 uint16_t，0 表示使用整帧缓冲区
  *
  * @return int 返回0表示成功，其他值表示错误码
  */
-int vi_chn_init(uint8_t channelId, uint16_t width, uint16_t height)
+int vi_chn_init(uint8_t devId, uint8_t channelId, uint16_t width, uint16_t height, uint8_t bufCount, uint16_t wrapLine)
 {
 	int ret; // 用于存储返回值
 
@@ -80,7 +84,7 @@ int vi_chn_init(uint8_t channelId, uint16_t width, uint16_t height)
 	VI_CHN_ATTR_S vi_chn_attr;						// 定义视频通道属性结构体
 	memset(&vi_chn_attr, 0, sizeof(VI_CHN_ATTR_S)); // 清零通道属性结构体
 
-	vi_chn_attr.stIspOpt.u32BufCount = 2;							// 设置缓冲区数量 2
+	vi_chn_attr.stIspOpt.u32BufCount = bufCount ? bufCount : 2;	// 设置缓冲区数量，默认 2
 	vi_chn_attr.stIspOpt.enMemoryType = VI_V4L2_MEMORY_TYPE_DMABUF; // 设置内存类型为 DMA 缓冲区
 	vi_chn_attr.stSize.u32Width = width;							// 设置图像宽度
 	vi_chn_attr.stSize.u32Height = height;							// 设置图像高度
@@ -89,8 +93,18 @@ int vi_chn_init(uint8_t channelId, uint16_t width, uint16_t height)
 	vi_chn_attr.u32Depth = 1;										// 设置深度为 1  //0, get fail; 1 - u32BufCount, can get, if bind to other device, must be < u32BufCount
 
 	// 设置通道属性并启用通道
-	ret = RK_MPI_VI_SetChnAttr(0, channelId, &vi_chn_attr); // 设置通道属性
-	ret |= RK_MPI_VI_EnableChn(0, channelId);				// 启用通道
+	ret = RK_MPI_VI_SetChnAttr(devId, channelId, &vi_chn_attr); // 设置通道属性
+	if (wrapLine > 0)
+	{
+		// 环形缓冲区模式：VI 只写入 wrapLine 行的环形缓冲区，VENC 在图像写完之前就开始编码上方的行
+		VI_CHN_BUF_WRAP_S vi_wrap;					   // 定义环形缓冲区属性结构体
+		memset(&vi_wrap, 0, sizeof(VI_CHN_BUF_WRAP_S)); // 清零环形缓冲区属性结构体
+		vi_wrap.bEnable = RK_TRUE;						   // 启用环形缓冲区
+		vi_wrap.u32BufLine = wrapLine;					   // 设置环形缓冲区行数
+		vi_wrap.u32WrapBufferSize = (RK_U32)wrapLine * width * 3 / 2; // 设置环形缓冲区大小（YUV420SP）
+		ret |= RK_MPI_VI_SetChnWrapBufAttr(devId, channelId, &vi_wrap);	  // 设置环形缓冲区属性，需在启用通道前设置
+	}
+	ret |= RK_MPI_VI_EnableChn(devId, channelId); // 启用通道
 	if (ret)												// 检查是否有错误
 	{
 		printf("ERROR: create VI error! ret=%d\n", ret); // 打印错误信息
@@ -176,16 +190,42 @@ int vpss_init(uint8_t VpssChn, uint16_t width, uint16_t height)
  * @param bitrate 编码比特率，类型为 uint8_t
  * @param fps 编码帧率，类型为 uint8_t
  * @param gop 图像组大小，类型为 uint8_t
+ * @param bufSize 码流缓冲区大小，类型为 uint32_t，0 表示使用整帧原始图像大小
+ * @param bufCnt 码流缓冲区数量，类型为 uint8_t，0 表示使用默认值 2
+ * @param wrapLine 与 VI 共享的环形缓冲区行数，类型为 uint16_t，0 表示按整帧接收
+ * @param frameBudget 单帧大小上限（字节），类型为 uint32_t，0 表示使用 AVBR 码率控制
  *
- * @return int 返回0表示成功，其他值表示错误码
+ * @return int 返回0表示成功，-1表示环形缓冲区设置失败，此时通道已销毁
  */
-int venc_init(uint8_t chnId, uint16_t width, uint16_t height, RK_CODEC_ID_E enType, uint8_t bitrate, uint8_t fps, uint8_t gop)
+int venc_init(uint8_t chnId, uint16_t width, uint16_t height, RK_CODEC_ID_E enType, uint8_t bitrate, uint8_t fps, uint8_t gop, uint32_t bufSize, uint8_t bufCnt, uint16_t wrapLine, uint32_t frameBudget)
 {
 	VENC_CHN_ATTR_S stAttr;						 // 定义编码通道属性结构体
 	memset(&stAttr, 0, sizeof(VENC_CHN_ATTR_S)); // 清零编码通道属性结构体
 
 	// 根据编码类型设置相应的属性
-	if (enType == RK_VIDEO_ID_AVC) // 如果编码类型为 H.264
+	if (frameBudget > 0 && enType == RK_VIDEO_ID_AVC) // 单帧预算模式，H.264 使用恒定比特率
+	{
+		stAttr.stRcAttr.enRcMode = VENC_RC_MODE_H264CBR;		   // 设置为 H.264 恒定比特率模式
+		stAttr.stRcAttr.stH264Cbr.u32BitRate = bitrate * 1024;	   // 设置比特率
+		stAttr.stRcAttr.stH264Cbr.u32StatTime = 1;				   // 设置统计时间（秒）
+		stAttr.stRcAttr.stH264Cbr.u32Gop = gop;					   // 设置 GOP 大小
+		stAttr.stRcAttr.stH264Cbr.u32SrcFrameRateNum = fps;	   // 设置源帧率
+		stAttr.stRcAttr.stH264Cbr.u32SrcFrameRateDen = 1;		   // 设置源帧率分母
+		stAttr.stRcAttr.stH264Cbr.fr32DstFrameRateNum = fps;	   // 设置目标帧率
+		stAttr.stRcAttr.stH264Cbr.fr32DstFrameRateDen = 1;		   // 设置目标帧率分母
+	}
+	else if (frameBudget > 0 && enType == RK_VIDEO_ID_HEVC) // 单帧预算模式，H.265 使用恒定比特率
+	{
+		stAttr.stRcAttr.enRcMode = VENC_RC_MODE_H265CBR;		   // 设置为 H.265 恒定比特率模式
+		stAttr.stRcAttr.stH265Cbr.u32BitRate = bitrate * 1024;	   // 设置比特率
+		stAttr.stRcAttr.stH265Cbr.u32StatTime = 1;				   // 设置统计时间（秒）
+		stAttr.stRcAttr.stH265Cbr.u32Gop = gop;					   // 设置 GOP 大小
+		stAttr.stRcAttr.stH265Cbr.u32SrcFrameRateNum = fps;	   // 设置源帧率
+		stAttr.stRcAttr.stH265Cbr.u32SrcFrameRateDen = 1;		   // 设置源帧率分母
+		stAttr.stRcAttr.stH265Cbr.fr32DstFrameRateNum = fps;	   // 设置目标帧率
+		stAttr.stRcAttr.stH265Cbr.fr32DstFrameRateDen = 1;		   // 设置目标帧率分母
+	}
+	else if (enType == RK_VIDEO_ID_AVC) // 如果编码类型为 H.264
 	{
 		stAttr.stRcAttr.enRcMode = VENC_RC_MODE_H264AVBR;				 // 设置为 H.264 自适应比特率模式
 		stAttr.stRcAttr.stH264Avbr.u32BitRate = bitrate * 1024;			 // 设置比特率
@@ -230,13 +270,68 @@ int venc_init(uint8_t chnId, uint16_t width, uint16_t height, RK_CODEC_ID_E enTy
 	stAttr.stVencAttr.u32PicHeight = height;			   // 设置图片高度
 	stAttr.stVencAttr.u32VirWidth = width;				   // 设置虚拟宽度
 	stAttr.stVencAttr.u32VirHeight = height;			   // 设置虚拟高度
-	stAttr.stVencAttr.u32StreamBufCnt = 2;				   // 设置流缓冲区数量
-	stAttr.stVencAttr.u32BufSize = width * height * 3 / 2; // 设置缓冲区大小
+	stAttr.stVencAttr.u32StreamBufCnt = bufCnt ? bufCnt : 2;					   // 设置流缓冲区数量
+	stAttr.stVencAttr.u32BufSize = bufSize ? bufSize : width * height * 3 / 2; // 设置缓冲区大小
 	stAttr.stVencAttr.enMirror = MIRROR_NONE;			   // 设置镜像模式
 
 	// 创建编码通道
 	RK_MPI_VENC_CreateChn(chnId, &stAttr);
 
+	if (wrapLine > 0)
+	{
+		// 环形缓冲区模式：与 VI 共享环形缓冲区，需在开始接收前设置
+		VENC_CHN_BUF_WRAP_S stVencWrap;						  // 定义环形缓冲区属性结构体
+		memset(&stVencWrap, 0, sizeof(VENC_CHN_BUF_WRAP_S)); // 清零环形缓冲区属性结构体
+		stVencWrap.bEnable = RK_TRUE;						  // 启用环形缓冲区
+		stVencWrap.u32BufLine = wrapLine;					  // 设置环形缓冲区行数，与 VI 一致
+		if (RK_MPI_VENC_SetChnBufWrapAttr(chnId, &stVencWrap) != RK_SUCCESS)
+		{
+			printf("RK_MPI_VENC_SetChnBufWrapAttr failed\n"); // 打印错误信息
+			RK_MPI_VENC_DestroyChn(chnId);					  // 销毁通道，由调用者回退到整帧模式或退出
+			return -1;										  // 返回失败
+		}
+	}
+
+	if (frameBudget > 0 && (enType == RK_VIDEO_ID_AVC || enType == RK_VIDEO_ID_HEVC))
+	{
+		// 超大帧处理：编码结果超过单帧预算时提高 QP 重新编码，优先保证帧大小而不是平均码率
+		VENC_SUPERFRAME_CFG_S stSuperFrm;						 // 定义超大帧策略结构体
+		memset(&stSuperFrm, 0, sizeof(VENC_SUPERFRAME_CFG_S)); // 清零超大帧策略结构体
+		stSuperFrm.enSuperFrmMode = SUPERFRM_REENCODE;			 // 超大帧重新编码
+		stSuperFrm.u32SuperIFrmBitsThr = frameBudget * 8;		 // I 帧大小上限（bit）
+		stSuperFrm.u32SuperPFrmBitsThr = frameBudget * 8;		 // P 帧大小上限（bit）
+		stSuperFrm.enRcPriority = VENC_RC_PRIORITY_FRAMEBITS_FIRST; // 帧大小优先
+		if (RK_MPI_VENC_SetSuperFrameStrategy(chnId, &stSuperFrm) != RK_SUCCESS)
+		{
+			printf("RK_MPI_VENC_SetSuperFrameStrategy failed\n"); // 打印错误信息
+		}
+
+		// 放开 QP 上限，使重新编码时能把 QP 提高到足以满足预算
+		VENC_RC_PARAM_S stRcParam;						   // 定义码率控制参数结构体
+		memset(&stRcParam, 0, sizeof(VENC_RC_PARAM_S)); // 清零码率控制参数结构体
+		if (RK_MPI_VENC_GetRcParam(chnId, &stRcParam) != RK_SUCCESS) // 获取默认码率控制参数
+		{
+			printf("RK_MPI_VENC_GetRcParam failed\n"); // 打印错误信息，不用清零的参数覆盖默认值
+		}
+		else
+		{
+			if (enType == RK_VIDEO_ID_AVC)
+			{
+				stRcParam.stParamH264.u32MaxQp = 51;  // P 帧最大 QP
+				stRcParam.stParamH264.u32MaxIQp = 51; // I 帧最大 QP
+			}
+			else
+			{
+				stRcParam.stParamH265.u32MaxQp = 51;  // P 帧最大 QP
+				stRcParam.stParamH265.u32MaxIQp = 51; // I 帧最大 QP
+			}
+			if (RK_MPI_VENC_SetRcParam(chnId, &stRcParam) != RK_SUCCESS)
+			{
+				printf("RK_MPI_VENC_SetRcParam failed\n"); // 打印错误信息
+			}
+		}
+	}
+
 	VENC_RECV_PIC_PARAM_S stRecvParam;						// 定义接收参数结构体
 	memset(&stRecvParam, 0, sizeof(VENC_RECV_PIC_PARAM_S)); // 清零接收参数结构体
 
@@ -245,3 +340,98 @@ int venc_init(uint8_t chnId, uint16_t width, uint16_t height, RK_CODEC_ID_E enTy
 
 	return 0; // 返回成功
 }
+
+/**
+ * @brief 设置编码通道的调度优先级和帧率控制
+ *
+ * @param chnId 编码通道 ID，类型为 uint8_t
+ * @param priority 通道优先级，类型为 uint32_t，多个通道共享编码器时数值大的先编码
+ * @param srcFps 输入帧率，类型为 uint8_t
+ * @param dstFps 编码帧率，类型为 uint8_t，小于输入帧率时编码器按比例丢弃输入帧
+ *
+ * @return int 返回0表示成功，其他值表示错误码
+ */
+int venc_set_chn_param(uint8_t chnId, uint32_t priority, uint8_t srcFps, uint8_t dstFps)
+{
+	VENC_CHN_PARAM_S stChnParam;						   // 定义编码通道参数结构体
+	memset(&stChnParam, 0, sizeof(VENC_CHN_PARAM_S));	   // 清零编码通道参数结构体
+	int ret = RK_MPI_VENC_GetChnParam(chnId, &stChnParam); // 获取当前通道参数
+	if (ret != RK_SUCCESS)
+	{
+		printf("RK_MPI_VENC_GetChnParam %x\n", ret); // 打印错误码
+		return ret;									  // 返回错误码
+	}
+
+	stChnParam.u32Priority = priority;							  // 设置通道优先级
+	stChnParam.stFrameRate.bEnable = dstFps < srcFps ? RK_TRUE : RK_FALSE; // 编码帧率低于输入帧率时启用帧率控制
+	stChnParam.stFrameRate.s32SrcFrmRate = srcFps;				  // 设置输入帧率
+	stChnParam.stFrameRate.s32DstFrmRate = dstFps;				  // 设置编码帧率
+	ret = RK_MPI_VENC_SetChnParam(chnId, &stChnParam);			  // 设置通道参数
+	if (ret != RK_SUCCESS)
+	{
+		printf("RK_MPI_VENC_SetChnParam %x\n", ret); // 打印错误码
+	}
+
+	return ret; // 返回结果
+}
+
+/**
+ * @brief 设置编码通道码率控制使用的帧率
+ *
+ * @param chnId 编码通道 ID，类型为 uint8_t
+ * @param fps 实际送入编码器的帧率，类型为 uint8_t
+ *
+ * @details 通道参数的帧率控制在码率控制之前丢帧，码率控制仍按创建时的帧率分配每帧的比特数时，实际码率会按比例降低。
+ * 降低编码帧率后需同步更新码率控制的帧率，使每帧分配到的比特数随之增加，保持设定的码率。
+ *
+ * @return int 返回0表示成功，其他值表示错误码
+ */
+int venc_set_rc_frame_rate(uint8_t chnId, uint8_t fps)
+{
+	VENC_CHN_ATTR_S stAttr;						 // 定义编码通道属性结构体
+	memset(&stAttr, 0, sizeof(VENC_CHN_ATTR_S)); // 清零编码通道属性结构体
+	int ret = RK_MPI_VENC_GetChnAttr(chnId, &stAttr); // 获取当前通道属性
+	if (ret != RK_SUCCESS)
+	{
+		printf("RK_MPI_VENC_GetChnAttr %x\n", ret); // 打印错误码
+		return ret;									 // 返回错误码
+	}
+
+	switch (stAttr.stRcAttr.enRcMode)
+	{
+	case VENC_RC_MODE_H264CBR:
+		stAttr.stRcAttr.stH264Cbr.u32SrcFrameRateNum = fps;  // 设置源帧率
+		stAttr.stRcAttr.stH264Cbr.u32SrcFrameRateDen = 1;	 // 设置源帧率分母
+		stAttr.stRcAttr.stH264Cbr.fr32DstFrameRateNum = fps; // 设置目标帧率
+		stAttr.stRcAttr.stH264Cbr.fr32DstFrameRateDen = 1;	 // 设置目标帧率分母
+		break;
+	case VENC_RC_MODE_H265CBR:
+		stAttr.stRcAttr.stH265Cbr.u32SrcFrameRateNum = fps;  // 设置源帧率
+		stAttr.stRcAttr.stH265Cbr.u32SrcFrameRateDen = 1;	 // 设置源帧率分母
+		stAttr.stRcAttr.stH265Cbr.fr32DstFrameRateNum = fps; // 设置目标帧率
+		stAttr.stRcAttr.stH265Cbr.fr32DstFrameRateDen = 1;	 // 设置目标帧率分母
+		break;
+	case VENC_RC_MODE_H264AVBR:
+		stAttr.stRcAttr.stH264Avbr.u32SrcFrameRateNum = fps;  // 设置源帧率
+		stAttr.stRcAttr.stH264Avbr.u32SrcFrameRateDen = 1;	  // 设置源帧率分母
+		stAttr.stRcAttr.stH264Avbr.fr32DstFrameRateNum = fps; // 设置目标帧率
+		stAttr.stRcAttr.stH264Avbr.fr32DstFrameRateDen = 1;	  // 设置目标帧率分母
+		break;
+	case VENC_RC_MODE_H265AVBR:
+		stAttr.stRcAttr.stH265Avbr.u32SrcFrameRateNum = fps;  // 设置源帧率
+		stAttr.stRcAttr.stH265Avbr.u32SrcFrameRateDen = 1;	  // 设置源帧率分母
+		stAttr.stRcAttr.stH265Avbr.fr32DstFrameRateNum = fps; // 设置目标帧率
+		stAttr.stRcAttr.stH265Avbr.fr32DstFrameRateDen = 1;	  // 设置目标帧率分母
+		break;
+	default:
+		return 0; // 其他码率控制模式不按帧率分配比特数
+	}
+
+	ret = RK_MPI_VENC_SetChnAttr(chnId, &stAttr); // 设置通道属性
+	if (ret != RK_SUCCESS)
+	{
+		printf("RK_MPI_VENC_SetChnAttr %x\n", ret); // 打印错误码
+	}
+
+	return ret; // 返回结果
+}
@@ -3,9 +3,14 @@
 #include <string.h> // 提供字符串处理功能，如strcmp
 #include <unistd.h> // 提供对POSIX操作系统API的访问，usleep用于线程暂停
 #include <time.h>	// 提供时间处理功能，包括nanosleep等
+#include <sched.h>	// 提供调度策略定义，如SCHED_FIFO
 
 #include "luckfox_mpi.h" // 自定义头文件，可能包含与多媒体处理相关的函数
 #include "gst_push.h"	 // 自定义头文件，可能包含与GStreamer推送数据相关的函数
+#include "mem_budget.h"	 // 自定义头文件，包含内存预算和内存统计相关的函数
+#include "rt_profile.h"	 // 自定义头文件，包含实时调度配置和帧间隔抖动统计相关的函数
+#include "frame_budget.h" // 自定义头文件，包含单帧预算解析和帧大小统计相关的函数
+#include "multi_stream.h" // 自定义头文件，包含多摄像头附加视频流和编码器调度相关的函数
 
 // 定义一些常量，用于设置默认程序参数
 #define DEFAULT_IP "127.0.0.1" // 默认主机IP地址
@@ -16,6 +21,18 @@
 #define DEFAULT_ENCONDEC 1	   // 默认视频编码方式(0为H264, 1为H265)
 #define DEFAULT_BITRATE 2	   // 定义比特率常量，设置为 2Mbps
 #define DEFAULT_GOP 15		   // 定义GOP常量，设置为 15
+#define DEFAULT_MEM_BUDGET 0   // 默认内存预算（KB），0 表示不启用内存预算模式
+#define DEFAULT_RT_CPU -1	   // 默认不绑定CPU
+#define DEFAULT_JITTER_REPORT 0 // 默认抖动统计输出间隔（秒），0 表示不输出
+#define DEFAULT_TRANSPORT "udp"	// 默认RTP包发送方式
+#define DEFAULT_PARAM_SETS_INTERVAL 1000 // 默认参数集重复间隔（毫秒）
+#define DEFAULT_WRAP_LINE 0		// 默认VI/VENC环形缓冲区行数，0 表示使用整帧缓冲区
+#define WRAP_LINE_ALIGN 16		// 环形缓冲区行数的对齐
+#define DEFAULT_FRAME_BUDGET 0	// 默认单帧预算（字节），0 表示不启用单帧预算模式
+#define DEFAULT_ENC_CAPACITY 250 // 默认编码器吞吐量（百万像素/秒），按1080p120估算，应按实测调整
+
+#define PEAK_FRAME_FILE "/userdata/luckfox_pico_rtp.peak" // 保存历史最大编码帧大小的文件
+#define MEM_REPORT_INTERVAL_US 10000000					  // 内存统计输出间隔（微秒）
 
 /**
  * @brief 获取当前时间（微秒）
@@ -37,8 +54,8 @@ RK_U64 TEST_COMM_GetNowUs(void)
  */
 void display_usage(const char *program_name)
 {
-	fprintf(stderr, "Usage: %s [-i host_ip] [-p host_port] [-w video_width] [-h video_height] [-f video_fps] [-e video_encodec(0:H264, 1:H265)] [-b video_bitrate] [-g video_gop]\n", program_name);
-	fprintf(stderr, "For example: %s -i 127.0.0.1 -p 5602 -w 1920 -h 1080 -f 90 -e 1 -b 2 -g 15\n", program_name);
+	fprintf(stderr, "Usage: %s [-i host_ip] [-p host_port] [-w video_width] [-h video_height] [-f video_fps] [-e video_encodec(0:H264, 1:H265)] [-b video_bitrate] [-g video_gop] [-M mem_budget_kb] [-r capture_rt_policy(fifo|rr|other):priority] [-s send_rt_policy(fifo|rr|other):priority] [-c rt_cpu] [-j jitter_report_sec] [-T transport(udp|unix:path|shm:path)] [-P param_sets_interval_ms] [-W wrap_lines(0:full frame)] [-F frame_budget(bytes|link_kbps:latency_ms)] [-S cam:widthxheight@fps:bitrate:port[:host]]... [-E encoder_mpix_per_sec]\n", program_name);
+	fprintf(stderr, "For example: %s -i 127.0.0.1 -p 5602 -w 1920 -h 1080 -f 90 -e 1 -b 2 -g 15 -M 16384 -r fifo:50 -c 0 -j 10 -T shm:/var/run/wfb_tx.sock -P 1000 -W 540 -F 8000:10 -S 1:1280x720@30:1:5603 -E 250\n", program_name);
 }
 
 /**
@@ -58,10 +75,26 @@ int main(int argc, char *argv[])
 	bool video_encodec = DEFAULT_ENCONDEC;	 // 视频编码方式的初始值
 	uint8_t video_bitrate = DEFAULT_BITRATE; // 视频编码比特率的初始值
 	uint8_t video_gop = DEFAULT_GOP;		 // 视频图像组大小的初始值
+	uint32_t mem_budget_kb = DEFAULT_MEM_BUDGET; // 内存预算的初始值
+	RtProfile_S rt_profile = {SCHED_OTHER, 0, DEFAULT_RT_CPU};		// 取流线程（主线程）实时调度配置的初始值
+	RtProfile_S send_rt_profile = {SCHED_OTHER, 0, DEFAULT_RT_CPU}; // 发送线程实时调度配置的初始值
+	bool rt_enable = false;						 // 是否启用取流线程的实时调度配置
+	bool send_rt_enable = false;				 // 是否启用发送线程的实时调度配置
+	uint32_t jitter_report_sec = DEFAULT_JITTER_REPORT; // 抖动统计输出间隔的初始值
+	uint32_t param_sets_interval_ms = DEFAULT_PARAM_SETS_INTERVAL; // 参数集重复间隔的初始值
+	uint16_t wrap_line = DEFAULT_WRAP_LINE;							// VI/VENC环形缓冲区行数的初始值
+	uint32_t frame_budget = DEFAULT_FRAME_BUDGET;					// 单帧预算的初始值
+	const char *extra_stream_args[MULTI_STREAM_MAX];				// 附加视频流配置字符串
+	StreamConfig_S extra_streams[MULTI_STREAM_MAX];					// 附加视频流配置
+	uint8_t extra_stream_cnt = 0;									// 附加视频流数量
+	uint32_t encoder_capacity = DEFAULT_ENC_CAPACITY;				// 编码器吞吐量的初始值
+	TransportType_E transport_type;						// RTP包发送方式
+	const char *transport_path;							// 本地传输通道的套接字路径
+	local_transport_parse(DEFAULT_TRANSPORT, &transport_type, &transport_path); // RTP包发送方式的初始值
 
 	// 解析命令行参数
 	int c;
-	while ((c = getopt(argc, argv, "i:p:w:h:f:e:b:g:")) != -1) // 逐个获取命令行选项
+	while ((c = getopt(argc, argv, "i:p:w:h:f:e:b:g:M:r:s:c:j:T:P:W:F:S:E:")) != -1) // 逐个获取命令行选项
 	{
 		switch (c)
 		{
@@ -89,6 +122,66 @@ int main(int argc, char *argv[])
 		case 'g':
 			video_gop = atoi(optarg); // 设置视频图像组大小
 			break;
+		case 'M':
+			mem_budget_kb = atoi(optarg); // 设置内存预算
+			break;
+		case 'r':
+			if (rt_profile_parse(optarg, &rt_profile) != 0) // 设置调度策略和优先级
+			{
+				display_usage(argv[0]); // 参数无效，显示使用说明
+				exit(EXIT_FAILURE);		// 退出程序
+			}
+			rt_enable = true;
+			break;
+		case 's':
+			if (rt_profile_parse(optarg, &send_rt_profile) != 0) // 设置发送线程的调度策略和优先级
+			{
+				display_usage(argv[0]); // 参数无效，显示使用说明
+				exit(EXIT_FAILURE);		// 退出程序
+			}
+			send_rt_enable = true;
+			break;
+		case 'c':
+			rt_profile.cpu = atoi(optarg);		// 设置绑定的CPU，取流和发送线程共用
+			send_rt_profile.cpu = rt_profile.cpu;
+			rt_enable = true;
+			send_rt_enable = true;
+			break;
+		case 'j':
+			jitter_report_sec = atoi(optarg); // 设置抖动统计输出间隔
+			break;
+		case 'T':
+			if (local_transport_parse(optarg, &transport_type, &transport_path) != 0) // 设置RTP包发送方式
+			{
+				display_usage(argv[0]); // 参数无效，显示使用说明
+				exit(EXIT_FAILURE);		// 退出程序
+			}
+			break;
+		case 'P':
+			param_sets_interval_ms = atoi(optarg); // 设置参数集重复间隔
+			break;
+		case 'W':
+			wrap_line = atoi(optarg); // 设置环形缓冲区行数
+			break;
+		case 'F':
+			if (frame_budget_parse(optarg, &frame_budget) != 0) // 设置单帧预算
+			{
+				display_usage(argv[0]); // 若参数无效，显示使用说明
+				exit(EXIT_FAILURE);		// 退出程序
+			}
+			break;
+		case 'S':
+			// 添加一路附加视频流，目标主机默认与主推流相同，因此在全部选项解析完后再解析
+			if (extra_stream_cnt >= MULTI_STREAM_MAX)
+			{
+				display_usage(argv[0]); // 超过最多附加视频流数量，显示使用说明
+				exit(EXIT_FAILURE);		// 退出程序
+			}
+			extra_stream_args[extra_stream_cnt++] = optarg;
+			break;
+		case 'E':
+			encoder_capacity = atoi(optarg); // 设置编码器吞吐量
+			break;
 		default:
 			display_usage(argv[0]); // 若无效选项，显示使用说明
 			exit(EXIT_FAILURE);		// 退出程序
@@ -102,8 +195,61 @@ int main(int argc, char *argv[])
 		exit(EXIT_SUCCESS);		// 正常退出
 	}
 
+	// 解析附加视频流配置，未指定目标主机时使用主推流的目标主机
+	for (uint8_t i = 0; i < extra_stream_cnt; i++)
+	{
+		if (multi_stream_parse(extra_stream_args[i], host_ip, &extra_streams[i]) != 0)
+		{
+			display_usage(argv[0]); // 若参数无效，显示使用说明
+			exit(EXIT_FAILURE);		// 退出程序
+		}
+	}
+
+	// 环形缓冲区行数按16行对齐，并限制在图像高度的1/4到整帧之间
+	if (wrap_line > 0)
+	{
+		if (wrap_line < video_height / 4)
+		{
+			wrap_line = video_height / 4;
+		}
+		wrap_line = (wrap_line + WRAP_LINE_ALIGN - 1) / WRAP_LINE_ALIGN * WRAP_LINE_ALIGN;
+		if (wrap_line > video_height)
+		{
+			wrap_line = video_height;
+		}
+	}
+
+	// 内存预算：根据预算和历史最大帧大小计算VI、VENC缓冲区和推流队列大小
+	MemBudget_S mem_plan;					  // 缓冲区配置
+	memset(&mem_plan, 0, sizeof(mem_plan)); // 未启用预算模式时全部为0，使用默认配置
+	uint32_t saved_peak = 0;				  // 已保存的历史最大编码帧大小
+	if (mem_budget_kb > 0)
+	{
+		saved_peak = mem_budget_load_peak(PEAK_FRAME_FILE);
+		if (mem_budget_plan(&mem_plan, mem_budget_kb, video_width, video_height, wrap_line, video_bitrate, saved_peak) != 0)
+		{
+			RK_LOGE("memory budget %uKB is too small, at least %uKB needed", mem_budget_kb, mem_plan.total_bytes / 1024); // 输出错误信息
+			return -1;																										  // 预算不足，退出程序
+		}
+		MemUsage_S mem_usage;					   // 启动时尚无运行数据
+		memset(&mem_usage, 0, sizeof(mem_usage));
+		mem_usage.peak_frame = saved_peak;
+		mem_budget_report(&mem_plan, &mem_usage); // 输出内存配置
+	}
+
+	// 单帧预算模式：平均帧大小超过预算时，大部分帧都需要重新编码
+	if (frame_budget > 0)
+	{
+		uint32_t avg_frame = (uint32_t)video_bitrate * 1024 * 1024 / 8 / (video_fps ? video_fps : 30); // 按码率计算的平均帧大小
+		printf("frame budget: %u bytes per frame, average frame at %uMbps is %u bytes\n", frame_budget, video_bitrate, avg_frame);
+		if (avg_frame > frame_budget)
+		{
+			RK_LOGE("bitrate %uMbps exceeds frame budget %u bytes at %ufps, lower -b", video_bitrate, frame_budget, video_fps); // 输出错误信息
+		}
+	}
+
 	// rk_aiq初始化
-	RK_BOOL multi_sensor = RK_FALSE;							 // 多传感器标志
+	RK_BOOL multi_sensor = extra_stream_cnt > 0 ? RK_TRUE : RK_FALSE; // 多传感器标志，有附加视频流时启用
 	const char *iq_dir = "/etc/iqfiles";						 // IQ文件目录
 	rk_aiq_working_mode_t hdr_mode = RK_AIQ_WORKING_MODE_NORMAL; // 工作模式设置
 	SAMPLE_COMM_ISP_Init(0, hdr_mode, multi_sensor, iq_dir);	 // 初始化图像信号处理（ISP）
@@ -124,6 +270,11 @@ int main(int argc, char *argv[])
 	gst_push_init_parameter.host_port = host_port;													  // 推送主机端口号
 	gst_push_init_parameter.encodec_type = video_encodec ? EncondecType_E_H265 : EncondecType_E_H264; // 编码方式选择
 	gst_push_init_parameter.fps = video_fps;														  // 视频帧率
+	gst_push_init_parameter.max_queue_bytes = mem_plan.queue_bytes;									  // 推流队列最大字节数
+	gst_push_init_parameter.rt_profile = send_rt_enable ? &send_rt_profile : NULL;				  // 发送线程的实时调度配置
+	gst_push_init_parameter.transport_type = transport_type;										  // RTP包发送方式
+	gst_push_init_parameter.transport_path = transport_path;										  // 本地传输通道的套接字路径
+	gst_push_init_parameter.param_sets_interval_ms = param_sets_interval_ms;						  // 参数集重复间隔
 
 	if (gst_push_init(&gst_push_init_parameter) != RK_SUCCESS) // 初始化GStreamer推送
 	{
@@ -132,12 +283,48 @@ int main(int argc, char *argv[])
 	}
 
 	// vi初始化
-	vi_dev_init();							   // 初始化视频输入设备
-	vi_chn_init(0, video_width, video_height); // 初始化视频输入通道
+	vi_dev_init(0);							   // 初始化视频输入设备
+	int ret = vi_chn_init(0, 0, video_width, video_height, mem_plan.vi_buf_cnt, wrap_line); // 初始化视频输入通道
 
 	// venc初始化
 	RK_CODEC_ID_E enCodecType = video_encodec ? RK_VIDEO_ID_HEVC : RK_VIDEO_ID_AVC;			   // 设置编码类型
-	venc_init(0, video_width, video_height, enCodecType, video_bitrate, video_fps, video_gop); // 初始化视频编码器
+	if (ret == 0)
+	{
+		ret = venc_init(0, video_width, video_height, enCodecType, video_bitrate, video_fps, video_gop, mem_plan.venc_buf_size, mem_plan.venc_buf_cnt, wrap_line, frame_budget); // 初始化视频编码器
+	}
+
+	// 环形缓冲区模式设置失败时回退到整帧模式，VI 和 VENC 必须使用同一种模式
+	if (ret != 0 && wrap_line > 0)
+	{
+		RK_LOGE("wrap mode init failed, fall back to full frame"); // 输出错误信息
+		RK_MPI_VI_DisableChn(0, 0);								   // 禁用环形缓冲区模式的视频输入通道
+		VI_CHN_BUF_WRAP_S vi_wrap;								   // 关闭 VI 环形缓冲区
+		memset(&vi_wrap, 0, sizeof(VI_CHN_BUF_WRAP_S));
+		RK_MPI_VI_SetChnWrapBufAttr(0, 0, &vi_wrap);
+		wrap_line = 0;
+
+		// 整帧模式下 VI 需要整帧缓冲区，重新检查内存预算
+		if (mem_budget_kb > 0 && mem_budget_plan(&mem_plan, mem_budget_kb, video_width, video_height, wrap_line, video_bitrate, saved_peak) != 0)
+		{
+			RK_LOGE("memory budget %uKB is too small for full frame mode, at least %uKB needed", mem_budget_kb, mem_plan.total_bytes / 1024); // 输出错误信息
+			return -1;																													   // 预算不足，退出程序
+		}
+
+		ret = vi_chn_init(0, 0, video_width, video_height, mem_plan.vi_buf_cnt, wrap_line);
+		if (ret == 0)
+		{
+			ret = venc_init(0, video_width, video_height, enCodecType, video_bitrate, video_fps, video_gop, mem_plan.venc_buf_size, mem_plan.venc_buf_cnt, wrap_line, frame_budget);
+		}
+	}
+	if (ret != 0)
+	{
+		RK_LOGE("vi/venc init failed"); // 输出错误信息
+		return -1;						// 初始化失败，退出程序
+	}
+
+	uint32_t vi_buf_bytes = wrap_line > 0 ? (uint32_t)wrap_line * video_width * 3 / 2
+										  : (uint32_t)(mem_plan.vi_buf_cnt ? mem_plan.vi_buf_cnt : 2) * video_width * video_height * 3 / 2; // VI缓冲区占用的内存
+	printf("capture mode: %s, wrap_line=%u, vi buffer %u KB\n", wrap_line > 0 ? "wrap" : "full frame", wrap_line, vi_buf_bytes / 1024);
 
 	// 绑定vi到venc
 	MPP_CHN_S stSrcChn, stvencChn; // 声明源通道和编码通道结构
@@ -159,23 +346,202 @@ int main(int argc, char *argv[])
 		return -1;							 // 绑定失败，退出程序
 	}
 
+	// 多摄像头：主推流之外的每路视频流在各自的线程中建立 ISP/VI/VENC 链路，按优先级共享编码器
+	if (extra_stream_cnt > 0)
+	{
+		multi_stream_init(video_width, video_height, video_fps, encoder_capacity);
+		for (uint8_t i = 0; i < extra_stream_cnt; i++)
+		{
+			multi_stream_start(&extra_streams[i], gst_push_init_parameter.encodec_type, param_sets_interval_ms);
+		}
+		// 等待各路链路建立完成，之后锁定内存时才包含其缓冲区
+		printf("%d of %u extra streams started\n", multi_stream_wait_ready(), extra_stream_cnt);
+	}
+
 	// 视频帧
 	VENC_STREAM_S stFrame;										  // 声明编码流结构
 	stFrame.pstPack = (VENC_PACK_S *)malloc(sizeof(VENC_PACK_S)); // 为编码包分配内存
 
 	FrameData_S frame; // 声明帧数据变量
 
+	uint32_t peak_frame = 0;						   // 运行期间观测到的最大编码帧大小
+	uint32_t venc_pending_max = 0;				   // VENC 码流缓冲区中尚未取走的字节数的最大值
+	uint32_t venc_dropped = 0;					   // 编码器内部丢弃的帧数
+	RK_U32 last_seq = 0;						   // 上一帧的编码帧序号
+	bool seq_valid = false;						   // last_seq 是否有效
+	bool push_dropping = false;					   // 推流队列是否正在丢帧
+	bool peak_dirty = false;					   // saved_peak 是否有尚未保存的更新
+	RK_U64 mem_report_time = TEST_COMM_GetNowUs(); // 上一次输出内存统计的时间
+
+	// 实时调度配置：ISP/MPI/GStreamer 的内部线程已在普通调度策略下创建，此时只设置主线程（编码取流和推送线程），
+	// 避免 rkaiq/rockit/GLib 线程继承实时优先级和CPU绑定；发送线程由 gst_push 在流线程启动时单独设置
+	if (rt_enable)
+	{
+		if (rt_profile_apply_thread(&rt_profile) != 0)
+		{
+			RK_LOGE("apply rt profile to capture thread failed"); // 输出错误信息，继续以普通调度策略运行
+		}
+	}
+	if (rt_enable || send_rt_enable)
+	{
+		if (rt_profile_lock_memory() != 0) // 锁定内存，避免缺页
+		{
+			RK_LOGE("lock memory failed, page faults may add latency"); // 输出错误信息，继续运行
+		}
+	}
+
+	JitterStats_S jitter_stats;								// 帧间隔抖动统计
+	jitter_stats_init(&jitter_stats, video_fps);			// 初始化抖动统计
+	RK_U64 jitter_report_time = TEST_COMM_GetNowUs(); // 上一次输出抖动统计的时间
+
+	RK_U64 capture_latency_sum = 0;	 // 统计周期内采集到取得码流的延迟累计值（微秒）
+	RK_U64 capture_latency_max = 0;	 // 统计周期内采集到取得码流的最大延迟（微秒）
+	uint32_t capture_latency_cnt = 0; // 统计周期内的帧数
+
+	FrameBudgetStats_S budget_stats;					   // 帧大小统计
+	frame_budget_stats_init(&budget_stats, frame_budget); // 初始化帧大小统计
+	RK_U64 report_interval = jitter_report_sec > 0 ? (RK_U64)jitter_report_sec * 1000000 : MEM_REPORT_INTERVAL_US; // 帧大小和多路视频流统计的输出间隔（微秒）
+	RK_U64 budget_report_time = TEST_COMM_GetNowUs();	   // 上一次输出帧大小统计的时间
+	RK_U64 stream_report_time = TEST_COMM_GetNowUs();	   // 上一次输出多路视频流统计的时间
+
 	while (true) // 无限循环处理视频流
 	{
 		// 获取编码流
 		if (RK_MPI_VENC_GetStream(0, &stFrame, -1) == RK_SUCCESS)
 		{
+			if (jitter_report_sec > 0)
+			{
+				// 统计取到编码帧的时间间隔与 1/fps 的偏差
+				RK_U64 now = TEST_COMM_GetNowUs();
+				jitter_stats_add(&jitter_stats, now);
+
+				// 统计采集到取得码流的延迟：VI 的 PTS 为采集时的单调时钟时间（微秒）
+				if (now > stFrame.pstPack->u64PTS)
+				{
+					RK_U64 latency = now - stFrame.pstPack->u64PTS;
+					capture_latency_sum += latency;
+					capture_latency_cnt++;
+					if (latency > capture_latency_max)
+					{
+						capture_latency_max = latency;
+					}
+				}
+
+				if (now - jitter_report_time >= (RK_U64)jitter_report_sec * 1000000)
+				{
+					jitter_report_time = now;
+					jitter_stats_report(&jitter_stats);
+					printf("capture->bitstream (%s) frames=%u avg=%lluus max=%lluus\n", wrap_line > 0 ? "wrap" : "full frame", capture_latency_cnt,
+						   (unsigned long long)(capture_latency_cnt ? capture_latency_sum / capture_latency_cnt : 0), (unsigned long long)capture_latency_max);
+					capture_latency_sum = 0;
+					capture_latency_max = 0;
+					capture_latency_cnt = 0;
+					if (transport_type != TransportType_E_UDP)
+					{
+						uint32_t sent, dropped; // 本地传输通道的发送、丢弃包数
+						local_transport_take_stats(&sent, &dropped);
+						printf("local transport: sent %u dropped %u\n", sent, dropped);
+					}
+				}
+			}
+
 			// 获取视频帧数据
 			frame.buffer = (uint8_t *)RK_MPI_MB_Handle2VirAddr(stFrame.pstPack->pMbBlk); // 获取视频帧数据
 			frame.size = stFrame.pstPack->u32Len;										 // 获取帧大小
 			frame.pts = stFrame.pstPack->u64PTS;										 // 获取PTS
 
-			gst_push_data(&frame); // 推送视频帧
+			if (gst_push_data(&frame) == GST_PUSH_DROPPED)
+			{
+				// 推流队列已满，丢弃到下一个关键帧，开始丢帧时请求编码关键帧以尽快恢复
+				if (!push_dropping)
+				{
+					RK_MPI_VENC_RequestIDR(0, RK_FALSE);
+					push_dropping = true;
+				}
+			}
+			else
+			{
+				push_dropping = false;
+			}
+
+			if (frame_budget > 0)
+			{
+				// 统计帧大小分布和超出预算的帧数
+				int key = video_encodec ? stFrame.pstPack->DataType.enH265EType == H265E_NALU_IDRSLICE
+										: stFrame.pstPack->DataType.enH264EType == H264E_NALU_IDRSLICE; // 是否为关键帧
+				frame_budget_stats_add(&budget_stats, frame.size, key);
+				if (TEST_COMM_GetNowUs() - budget_report_time >= report_interval)
+				{
+					budget_report_time = TEST_COMM_GetNowUs();
+					frame_budget_stats_report(&budget_stats);
+				}
+			}
+
+			if (extra_stream_cnt > 0)
+			{
+				// 主推流延迟用于调度附加视频流的编码帧率
+				RK_U64 now = TEST_COMM_GetNowUs();
+				multi_stream_primary_frame(now > frame.pts ? now - frame.pts : 0, frame.size);
+				if (now - stream_report_time >= report_interval)
+				{
+					stream_report_time = now;
+					multi_stream_report();
+				}
+			}
+
+			if (mem_budget_kb > 0)
+			{
+				// 码流缓冲区不足时编码器直接丢弃整帧，取到的帧大小无法反映，需要根据编码器状态判断：
+				// 帧序号不连续表示编码器丢帧，尚未取走的字节数反映码流缓冲区的实际占用
+				VENC_CHN_STATUS_S venc_status;
+				if (RK_MPI_VENC_QueryStatus(0, &venc_status) == RK_SUCCESS && venc_status.u32LeftStreamBytes > venc_pending_max)
+				{
+					venc_pending_max = venc_status.u32LeftStreamBytes;
+				}
+				if (seq_valid && stFrame.u32Seq > last_seq + 1)
+				{
+					venc_dropped += stFrame.u32Seq - last_seq - 1;
+					RK_LOGE("venc dropped %u frames, stream buffer %ux%u may be too small", stFrame.u32Seq - last_seq - 1,
+							mem_plan.venc_buf_cnt, mem_plan.venc_buf_size);
+					// 真实的最大帧大小未知，下次启动时按当前缓冲区的两倍分配
+					if (saved_peak < mem_plan.venc_buf_size * 2)
+					{
+						saved_peak = mem_plan.venc_buf_size * 2;
+						peak_dirty = true;
+					}
+				}
+				last_seq = stFrame.u32Seq;
+				seq_valid = true;
+
+				// 记录最大编码帧大小，增长超过10%时标记待保存，供下次启动时计算缓冲区大小
+				if (frame.size > peak_frame)
+				{
+					peak_frame = frame.size;
+					if (peak_frame > saved_peak + saved_peak / 10)
+					{
+						saved_peak = peak_frame;
+						peak_dirty = true;
+					}
+				}
+
+				// 周期性输出内存统计，并保存最大编码帧大小：写文件只在统计周期内进行一次，不在每帧的热路径上
+				if (TEST_COMM_GetNowUs() - mem_report_time >= MEM_REPORT_INTERVAL_US)
+				{
+					mem_report_time = TEST_COMM_GetNowUs();
+					if (peak_dirty)
+					{
+						mem_budget_save_peak(PEAK_FRAME_FILE, saved_peak);
+						peak_dirty = false;
+					}
+					MemUsage_S mem_usage; // 运行期间观测到的内存使用情况
+					mem_usage.gst_queue_bytes = gst_push_queue_bytes();
+					mem_usage.gst_dropped = gst_push_dropped_frames();
+					mem_usage.peak_frame = peak_frame;
+					mem_usage.venc_pending_max = venc_pending_max;
+					mem_usage.venc_dropped = venc_dropped;
+					mem_budget_report(&mem_plan, &mem_usage);
+				}
+			}
 
 			// printf("fps = %.2f\n", (float)1000000 / (float)(TEST_COMM_GetNowUs() - frame.pts)); // 输出当前帧率
 		}
@@ -187,6 +553,13 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	if (peak_dirty)
+	{
+		mem_budget_save_peak(PEAK_FRAME_FILE, saved_peak); // 保存尚未写入的最大编码帧大小
+	}
+
+	multi_stream_stop(); // 停止附加视频流
+
 	// 解除绑定输入通道和编码器
 	RK_MPI_SYS_UnBind(&stSrcChn, &stvencChn);
 
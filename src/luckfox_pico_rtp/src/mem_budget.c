@@ -0,0 +1,193 @@
+#include <stdio.h>	 // 引入标准输入输出库，支持打印和文件操作
+#include <string.h>	 // 引入字符串处理库
+#include <malloc.h>	 // 引入mallinfo/mallinfo2，用于统计堆内存
+#include "mem_budget.h" // 引入内存预算模块的声明
+
+#define MEM_BUDGET_ALIGN 4096				   // 缓冲区大小按页对齐
+#define MEM_BUDGET_MIN_FRAME (64 * 1024)	   // 估计的最大编码帧大小下限
+#define MEM_BUDGET_PEAK_MARGIN_NUM 5		   // 历史最大帧大小的余量系数分子（1.25倍）
+#define MEM_BUDGET_PEAK_MARGIN_DEN 4		   // 历史最大帧大小的余量系数分母
+#define MEM_BUDGET_SEED_MS 1000				   // 没有历史数据时，按目标码率下多长时间的数据量估计最大编码帧大小（毫秒）
+#define MEM_BUDGET_VENC_REF_FRAMES 2		   // VENC内部参考帧和重建帧占用的原始帧数量（估计值）
+#define MEM_BUDGET_HEAP_RESERVE (2 * 1024 * 1024) // 为GStreamer/GLib等堆内存预留的大小
+
+#define ALIGN_UP(x, a) (((x) + (a)-1) / (a) * (a))
+
+// 缓冲区配置档位：VI 缓冲区数量、VENC 码流缓冲区数量、推流队列可容纳的最大帧数量，按从宽裕到最小的顺序尝试
+static const uint8_t mem_budget_tiers[][3] = {
+	{3, 2, 2}, // VI 三缓冲，采集在编码繁忙时仍有空闲缓冲区
+	{2, 2, 2}, // 双缓冲
+	{2, 1, 1}, // 最小配置，VI 与 VENC 绑定时至少需要2个缓冲区
+};
+
+/**
+ * @brief 从 /proc 文件中读取形如 "Key:   value kB" 的字段
+ *
+ * @return unsigned long 字段值（kB），读取失败返回0
+ */
+static unsigned long read_proc_kb(const char *path, const char *key)
+{
+	char line[128];			// 行缓冲区
+	unsigned long value = 0; // 字段值
+	size_t key_len = strlen(key);
+
+	FILE *fp = fopen(path, "r");
+	if (fp == NULL)
+	{
+		return 0;
+	}
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		if (strncmp(line, key, key_len) == 0 && line[key_len] == ':')
+		{
+			sscanf(line + key_len + 1, "%lu", &value);
+			break;
+		}
+	}
+	fclose(fp);
+
+	return value;
+}
+
+/**
+ * @brief 计算指定缓冲区数量下预计占用的总内存
+ */
+static uint32_t mem_budget_total(const MemBudget_S *plan)
+{
+	return plan->vi_bytes											  // VI 缓冲区
+		   + MEM_BUDGET_VENC_REF_FRAMES * plan->raw_frame_size		  // VENC 参考帧
+		   + plan->venc_buf_cnt * plan->venc_buf_size				  // VENC 码流缓冲区
+		   + plan->queue_bytes										  // 推流队列
+		   + MEM_BUDGET_HEAP_RESERVE;								  // 堆内存预留
+}
+
+/**
+ * @brief 根据内存预算计算 VI、VENC 缓冲区和推流队列的大小
+ *
+ * @details 最大编码帧大小优先使用历史观测值（加25%余量）。没有历史数据时按目标码率下 MEM_BUDGET_SEED_MS
+ * 的数据量估计（即假定 IDR 帧不超过1秒的平均数据量），不超过整帧原始图像大小；估计偏小时编码器会丢帧，
+ * 运行期间由帧序号检测到后增大保存的最大帧大小，下次启动时按新的值分配。
+ * 按 mem_budget_tiers 从宽裕到最小依次尝试，选出预算内最宽裕的 VI/VENC 缓冲区数量和推流队列大小。
+ * 环形缓冲区模式下 VI 不再分配整帧缓冲区，只计入 wrap_line 行的环形缓冲区。
+ */
+int mem_budget_plan(MemBudget_S *plan, uint32_t budget_kb, uint16_t width, uint16_t height, uint16_t wrap_line, uint8_t bitrate, uint32_t peak_frame)
+{
+	memset(plan, 0, sizeof(MemBudget_S)); // 清零配置结构体
+
+	plan->budget_kb = budget_kb;
+	plan->wrap_line = wrap_line;
+	plan->raw_frame_size = (uint32_t)width * height * 3 / 2; // YUV420SP 单帧大小
+
+	// 估计最大编码帧大小
+	if (peak_frame > 0)
+	{
+		plan->peak_frame = peak_frame * MEM_BUDGET_PEAK_MARGIN_NUM / MEM_BUDGET_PEAK_MARGIN_DEN;
+	}
+	else
+	{
+		plan->peak_frame = (uint32_t)((uint64_t)bitrate * 1024 * 1000 / 8 * MEM_BUDGET_SEED_MS / 1000); // 首次运行，按目标码率估计
+	}
+	if (plan->peak_frame < MEM_BUDGET_MIN_FRAME)
+	{
+		plan->peak_frame = MEM_BUDGET_MIN_FRAME;
+	}
+	if (plan->peak_frame > plan->raw_frame_size)
+	{
+		plan->peak_frame = plan->raw_frame_size; // 编码帧不会超过原始帧大小
+	}
+	plan->venc_buf_size = ALIGN_UP(plan->peak_frame, MEM_BUDGET_ALIGN);
+
+	for (size_t i = 0; i < sizeof(mem_budget_tiers) / sizeof(mem_budget_tiers[0]); i++)
+	{
+		plan->vi_buf_cnt = mem_budget_tiers[i][0];
+		plan->vi_bytes = wrap_line > 0 ? (uint32_t)wrap_line * width * 3 / 2 : plan->vi_buf_cnt * plan->raw_frame_size;
+		plan->venc_buf_cnt = mem_budget_tiers[i][1];
+		plan->queue_bytes = mem_budget_tiers[i][2] * plan->venc_buf_size;
+		plan->total_bytes = mem_budget_total(plan);
+		if (plan->total_bytes <= (uint64_t)budget_kb * 1024)
+		{
+			return 0;
+		}
+	}
+
+	return -1; // 最小配置也超出预算，total_bytes 为最小配置所需的内存
+}
+
+/**
+ * @brief 读取保存的最大编码帧大小
+ */
+uint32_t mem_budget_load_peak(const char *path)
+{
+	unsigned int peak_frame = 0; // 最大编码帧大小
+
+	FILE *fp = fopen(path, "r");
+	if (fp == NULL)
+	{
+		return 0;
+	}
+	if (fscanf(fp, "%u", &peak_frame) != 1)
+	{
+		peak_frame = 0;
+	}
+	fclose(fp);
+
+	return peak_frame;
+}
+
+/**
+ * @brief 保存最大编码帧大小，供下次启动时计算缓冲区大小
+ */
+void mem_budget_save_peak(const char *path, uint32_t peak_frame)
+{
+	FILE *fp = fopen(path, "w");
+	if (fp == NULL)
+	{
+		printf("save peak frame size to %s failed\n", path);
+		return;
+	}
+	fprintf(fp, "%u\n", peak_frame);
+	fclose(fp);
+}
+
+/**
+ * @brief 分别输出 MPI 内存块、堆和 GStreamer 的内存占用
+ *
+ * @details MPI 部分为本进程按配置申请的 VI/VENC 缓冲区大小之和（参考帧为估计值），同时给出整个系统的
+ * CMA 已用大小作为参考；堆内存为 malloc 已分配的字节数，其中包含 GStreamer/GLib 的分配，无法单独区分；
+ * GStreamer 部分只统计推流队列中尚未发送的字节数。
+ */
+void mem_budget_report(const MemBudget_S *plan, const MemUsage_S *usage)
+{
+	unsigned long cma_total = read_proc_kb("/proc/meminfo", "CmaTotal");
+	unsigned long cma_free = read_proc_kb("/proc/meminfo", "CmaFree");
+	unsigned long rss = read_proc_kb("/proc/self/status", "VmRSS");
+#if defined(__GLIBC__) && !defined(__UCLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	struct mallinfo2 mi = mallinfo2(); // glibc 2.33 及以上，mallinfo 已弃用
+	unsigned long heap_used = mi.uordblks;
+#else
+	struct mallinfo mi = mallinfo();
+	unsigned long heap_used = (unsigned int)mi.uordblks;
+#endif
+	uint32_t ref_bytes = MEM_BUDGET_VENC_REF_FRAMES * plan->raw_frame_size;	 // VENC 参考帧（估计）
+	uint32_t stream_bytes = plan->venc_buf_cnt * plan->venc_buf_size;		 // VENC 码流缓冲区
+
+	printf("mem budget=%uKB planned=%uKB headroom=%dKB\n",
+		   plan->budget_kb, plan->total_bytes / 1024, (int)plan->budget_kb - (int)(plan->total_bytes / 1024));
+	if (plan->wrap_line > 0)
+	{
+		printf("mem mpi(this process, planned): vi=wrap %u lines %uKB", plan->wrap_line, plan->vi_bytes / 1024);
+	}
+	else
+	{
+		printf("mem mpi(this process, planned): vi=%ux%uKB", plan->vi_buf_cnt, plan->raw_frame_size / 1024);
+	}
+	printf(" venc_stream=%ux%uKB venc_ref~%uKB total~%uKB (system cma_used=%luKB)\n",
+		   plan->venc_buf_cnt, plan->venc_buf_size / 1024,
+		   ref_bytes / 1024, (plan->vi_bytes + ref_bytes + stream_bytes) / 1024,
+		   cma_total - cma_free);
+	printf("mem venc_stream: pending_max=%uKB/%uKB dropped=%u peak_frame=%uKB\n",
+		   usage->venc_pending_max / 1024, stream_bytes / 1024, usage->venc_dropped, usage->peak_frame / 1024);
+	printf("mem heap(malloc, incl. GLib/GStreamer): used=%luKB rss=%luKB\n", heap_used / 1024, rss);
+	printf("mem gst queue: %lluKB/%uKB dropped=%u\n",
+		   (unsigned long long)usage->gst_queue_bytes / 1024, plan->queue_bytes / 1024, usage->gst_dropped);
+}
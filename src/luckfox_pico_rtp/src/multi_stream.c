@@ -0,0 +1,594 @@
+#include <stdio.h>			 // 引入标准输入输出库，支持打印功能
+#include <stdlib.h>			 // 引入malloc、free
+#include <string.h>			 // 引入字符串处理库
+#include <time.h>			 // 引入clock_gettime
+#include <sched.h>			 // 引入SCHED_OTHER
+#include <unistd.h>			 // 引入usleep
+#include <pthread.h>		 // 引入线程接口
+#include "luckfox_mpi.h"	 // 引入ISP/VI/VENC初始化函数
+#include "rt_profile.h"		 // 引入线程调度配置
+#include "multi_stream.h"	 // 引入多路视频流的声明
+
+#define MULTI_STREAM_IQ_DIR "/etc/iqfiles"	// IQ文件目录
+#define MULTI_STREAM_PRIMARY_PRIORITY 8		// 主推流编码通道的优先级，附加视频流依次递减
+#define MULTI_STREAM_MAX_DIVISOR 8			// 附加视频流编码帧率的最大降频倍数
+#define MULTI_STREAM_RELAX_WINDOWS 4		// 主推流延迟连续正常多少个窗口后才恢复附加视频流的帧率
+#define MULTI_STREAM_GET_TIMEOUT_MS 100		// 附加视频流取码流的超时时间，用于响应停止请求
+#define MULTI_STREAM_BASELINE_DECAY 64		// 基准延迟每个窗口向窗口平均延迟靠拢的比例（1/64）
+#define MULTI_STREAM_READY_TIMEOUT_MS 10000 // 等待全部附加视频流链路建立的超时时间（毫秒）
+#define MULTI_STREAM_READY_POLL_US 10000	// 等待链路建立时的查询间隔（微秒）
+
+// 附加视频流线程的状态
+#define MULTI_STREAM_STATE_STARTING 0 // 正在建立链路
+#define MULTI_STREAM_STATE_ACTIVE 1	  // 链路已建立，正在取流
+#define MULTI_STREAM_STATE_EXITED 2	  // 链路建立失败或已停止，线程已退出或即将退出
+
+// 链路建立的阶段，释放时从已完成的阶段开始逆序释放
+#define MULTI_STREAM_CHAIN_ISP 1  // ISP 已运行
+#define MULTI_STREAM_CHAIN_VI 2	  // VI 已启用
+#define MULTI_STREAM_CHAIN_VENC 3 // VENC 已开始接收
+#define MULTI_STREAM_CHAIN_BIND 4 // VI 已绑定到 VENC
+#define MULTI_STREAM_CHAIN_GST 5  // 推流管道已建立
+
+// 定义一个结构体，用于统计一路视频流在统计周期内的数据
+typedef struct
+{
+	uint32_t frames;	  // 帧数
+	uint64_t bytes;		  // 字节数
+	uint64_t latency_sum; // 采集到取得码流的延迟累计值（微秒）
+	uint64_t latency_max; // 采集到取得码流的最大延迟（微秒）
+} StreamStats_S;
+
+// 定义一个结构体，用于存储一路视频流的运行状态，下标0为主推流
+typedef struct
+{
+	StreamConfig_S cfg;				 // 视频流配置
+	uint8_t id;						 // VENC 通道和推流编号
+	uint8_t admit_divisor;			 // 启动时按编码器吞吐量确定的降频倍数
+	uint8_t divisor;				 // 调度确定的降频倍数，编码帧率为 fps / divisor，跨线程原子访问
+	uint8_t applied_divisor;		 // 已设置到编码通道的降频倍数，只由本路线程访问
+	EncondecType_E encodec_type;	 // 编码类型
+	uint32_t param_sets_interval_ms; // 周期性重复参数集的间隔（毫秒）
+	pthread_t thread;				 // 取流和推送线程
+	int running;					 // 线程是否继续运行，由停止请求清零，跨线程原子访问
+	int state;						 // 线程状态 MULTI_STREAM_STATE_*，跨线程原子访问
+	StreamStats_S stats;			 // 统计周期内的数据
+} StreamState_S;
+
+static StreamState_S streams[GST_PUSH_MAX_STREAMS];					// 各路视频流的状态
+static uint8_t stream_count = 1;									// 视频流数量，包含主推流
+static uint64_t encoder_capacity = 0;								// 编码器吞吐量（像素/秒）
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;		// 保护统计数据
+static pthread_mutex_t init_lock = PTHREAD_MUTEX_INITIALIZER;		// 串行化各路链路的建立
+static uint64_t report_time_us = 0;									// 上一次输出统计的时间
+
+// 主推流延迟保护：按窗口统计主推流的平均延迟，与观测到的最小窗口平均延迟比较
+static uint32_t guard_window_frames = 0; // 每个窗口的帧数
+static uint32_t guard_frames = 0;		 // 当前窗口的帧数
+static uint64_t guard_latency_sum = 0;	 // 当前窗口的延迟累计值（微秒）
+static uint64_t guard_baseline_us = 0;	 // 基准延迟（微秒），近似编码器空闲时的窗口平均延迟，0 表示尚无数据
+static uint32_t guard_good_windows = 0;	 // 连续延迟正常的窗口数量
+
+/**
+ * @brief 获取当前单调时钟时间（微秒），与 VENC 码流的 PTS 为同一时间基准
+ */
+static uint64_t multi_stream_now_us(void)
+{
+	struct timespec time = {0, 0}; // 定义一个 timespec 结构体用于存储时间
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t)time.tv_sec * 1000000 + (uint64_t)time.tv_nsec / 1000;
+}
+
+/**
+ * @brief 计算一路视频流在指定降频倍数下的编码帧率
+ */
+static uint8_t multi_stream_dst_fps(const StreamState_S *st, uint8_t divisor)
+{
+	uint8_t fps = st->cfg.fps / divisor; // 编码帧率
+	return fps ? fps : 1;
+}
+
+/**
+ * @brief 读取调度确定的降频倍数
+ */
+static uint8_t multi_stream_divisor(const StreamState_S *st)
+{
+	return __atomic_load_n(&st->divisor, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 一路附加视频流的链路是否已建立并在取流
+ */
+static int multi_stream_active(const StreamState_S *st)
+{
+	return __atomic_load_n(&st->state, __ATOMIC_ACQUIRE) == MULTI_STREAM_STATE_ACTIVE;
+}
+
+/**
+ * @brief 计算一路视频流在当前降频倍数下的编码负载（像素/秒）
+ */
+static uint64_t multi_stream_load(const StreamState_S *st)
+{
+	return (uint64_t)st->cfg.width * st->cfg.height * multi_stream_dst_fps(st, multi_stream_divisor(st));
+}
+
+/**
+ * @brief 按调度确定的降频倍数设置附加视频流的编码通道
+ *
+ * @details 只在本路线程中调用，设置通道参数会阻塞，不能放在主推流的实时线程中。
+ * 通道参数按降频后的帧率丢弃输入帧，码率控制的帧率同步改为降频后的帧率，保持设定的码率。
+ */
+static void multi_stream_apply(StreamState_S *st)
+{
+	st->applied_divisor = multi_stream_divisor(st);
+	uint8_t dst_fps = multi_stream_dst_fps(st, st->applied_divisor); // 编码帧率
+	venc_set_chn_param(st->id, MULTI_STREAM_PRIMARY_PRIORITY - st->id, st->cfg.fps, dst_fps);
+	venc_set_rc_frame_rate(st->id, dst_fps);
+}
+
+/**
+ * @brief 记录一帧到统计数据
+ */
+static void multi_stream_stats_add(StreamState_S *st, uint64_t latency_us, uint32_t size)
+{
+	pthread_mutex_lock(&stats_lock);
+	st->stats.frames++;
+	st->stats.bytes += size;
+	st->stats.latency_sum += latency_us;
+	if (latency_us > st->stats.latency_max)
+	{
+		st->stats.latency_max = latency_us;
+	}
+	pthread_mutex_unlock(&stats_lock);
+}
+
+/**
+ * @brief 解析形如 "1:1280x720@30:1:5603" 或 "1:1280x720@30:1:5603:192.168.1.2" 的附加视频流配置
+ */
+int multi_stream_parse(const char *arg, const char *default_ip, StreamConfig_S *cfg)
+{
+	unsigned int cam, width, height, fps, bitrate, port; // 解析出的字段
+	int consumed = 0;									 // 已解析的字符数
+
+	memset(cfg, 0, sizeof(StreamConfig_S));
+	if (sscanf(arg, "%u:%ux%u@%u:%u:%u%n", &cam, &width, &height, &fps, &bitrate, &port, &consumed) != 6)
+	{
+		return -1;
+	}
+	if (cam == 0 || cam > 255 || width == 0 || width > 65535 || height == 0 || height > 65535 ||
+		fps == 0 || fps > 255 || bitrate == 0 || bitrate > 255 || port == 0 || port > 65535)
+	{
+		return -1; // 摄像头0固定用于主推流
+	}
+
+	const char *host = arg[consumed] == ':' ? arg + consumed + 1 : default_ip; // 目标主机
+	if ((arg[consumed] != '\0' && arg[consumed] != ':') || strlen(host) == 0 || strlen(host) >= MULTI_STREAM_HOST_LEN)
+	{
+		return -1;
+	}
+
+	cfg->cam_id = cam;
+	cfg->width = width;
+	cfg->height = height;
+	cfg->fps = fps;
+	cfg->bitrate = bitrate;
+	cfg->host_port = port;
+	strcpy(cfg->host_ip, host);
+	return 0;
+}
+
+/**
+ * @brief 初始化多路视频流调度
+ */
+void multi_stream_init(uint16_t width, uint16_t height, uint8_t fps, uint32_t capacity_mpix)
+{
+	memset(streams, 0, sizeof(streams));
+	stream_count = 1;
+	encoder_capacity = (uint64_t)capacity_mpix * 1000000;
+
+	// 主推流始终以设定的帧率编码，不参与降频
+	streams[0].cfg.width = width;
+	streams[0].cfg.height = height;
+	streams[0].cfg.fps = fps;
+	streams[0].divisor = 1;
+	streams[0].admit_divisor = 1;
+
+	guard_window_frames = fps / 2 ? fps / 2 : 1; // 约半秒一个窗口
+	guard_frames = 0;
+	guard_latency_sum = 0;
+	guard_baseline_us = 0;
+	guard_good_windows = 0;
+	report_time_us = multi_stream_now_us();
+}
+
+/**
+ * @brief 逆序释放一路附加视频流已建立的链路和推流管道
+ *
+ * @param st 视频流
+ * @param stage 已完成的链路建立阶段，MULTI_STREAM_CHAIN_*
+ */
+static void multi_stream_chain_release(StreamState_S *st, int stage)
+{
+	uint8_t cam = st->cfg.cam_id; // 摄像头编号
+
+	MPP_CHN_S stSrcChn, stvencChn; // 声明源通道和编码通道结构
+	stSrcChn.enModId = RK_ID_VI;
+	stSrcChn.s32DevId = cam;
+	stSrcChn.s32ChnId = 0;
+	stvencChn.enModId = RK_ID_VENC;
+	stvencChn.s32DevId = 0;
+	stvencChn.s32ChnId = st->id;
+
+	switch (stage)
+	{
+	case MULTI_STREAM_CHAIN_GST:
+		gst_push_stream_deinit(st->id);
+		// fall through
+	case MULTI_STREAM_CHAIN_BIND:
+		RK_MPI_SYS_UnBind(&stSrcChn, &stvencChn);
+		// fall through
+	case MULTI_STREAM_CHAIN_VENC:
+		RK_MPI_VENC_StopRecvFrame(st->id);
+		RK_MPI_VENC_DestroyChn(st->id);
+		// fall through
+	case MULTI_STREAM_CHAIN_VI:
+		RK_MPI_VI_DisableChn(cam, 0);
+		RK_MPI_VI_DisableDev(cam);
+		// fall through
+	case MULTI_STREAM_CHAIN_ISP:
+		SAMPLE_COMM_ISP_Stop(cam);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief 建立一路附加视频流的 ISP/VI/VENC 链路和推流管道
+ *
+ * @details 任一步失败时逆序释放已建立的部分，不留下运行中的 ISP/VI/VENC。
+ */
+static int multi_stream_chain_init(StreamState_S *st)
+{
+	uint8_t cam = st->cfg.cam_id; // 摄像头编号
+
+	// ISP初始化，多摄像头模式
+	if (SAMPLE_COMM_ISP_Init(cam, RK_AIQ_WORKING_MODE_NORMAL, RK_TRUE, MULTI_STREAM_IQ_DIR) != RK_SUCCESS)
+	{
+		printf("stream %u: ISP init for camera %u failed\n", st->id, cam);
+		return -1;
+	}
+	SAMPLE_COMM_ISP_Run(cam);
+
+	// VI初始化，每个摄像头使用自己的设备和管道的0号通道
+	if (vi_dev_init(cam) != 0 || vi_chn_init(cam, 0, st->cfg.width, st->cfg.height, 0, 0) != 0)
+	{
+		printf("stream %u: VI init for camera %u failed\n", st->id, cam);
+		multi_stream_chain_release(st, MULTI_STREAM_CHAIN_VI);
+		return -1;
+	}
+
+	// VENC初始化，GOP取1秒
+	RK_CODEC_ID_E enCodecType = st->encodec_type == EncondecType_E_H265 ? RK_VIDEO_ID_HEVC : RK_VIDEO_ID_AVC;
+	if (venc_init(st->id, st->cfg.width, st->cfg.height, enCodecType, st->cfg.bitrate, st->cfg.fps, st->cfg.fps, 0, 0, 0, 0) != 0)
+	{
+		printf("stream %u: VENC init failed\n", st->id);
+		multi_stream_chain_release(st, MULTI_STREAM_CHAIN_VI);
+		return -1;
+	}
+	multi_stream_apply(st);
+
+	// 绑定vi到venc
+	MPP_CHN_S stSrcChn, stvencChn; // 声明源通道和编码通道结构
+	stSrcChn.enModId = RK_ID_VI;
+	stSrcChn.s32DevId = cam;
+	stSrcChn.s32ChnId = 0;
+	stvencChn.enModId = RK_ID_VENC;
+	stvencChn.s32DevId = 0;
+	stvencChn.s32ChnId = st->id;
+	if (RK_MPI_SYS_Bind(&stSrcChn, &stvencChn) != RK_SUCCESS)
+	{
+		printf("stream %u: bind vi%u to venc%u failed\n", st->id, cam, st->id);
+		multi_stream_chain_release(st, MULTI_STREAM_CHAIN_VENC);
+		return -1;
+	}
+
+	// 推流管道，流线程继承本线程的普通调度策略
+	GstPushInitParameter_S param;
+	memset(&param, 0, sizeof(param));
+	param.host_ip = st->cfg.host_ip;
+	param.host_port = st->cfg.host_port;
+	param.encodec_type = st->encodec_type;
+	param.fps = st->cfg.fps;
+	param.transport_type = TransportType_E_UDP;
+	param.param_sets_interval_ms = st->param_sets_interval_ms;
+	if (gst_push_stream_init(st->id, &param) != 0)
+	{
+		printf("stream %u: gst push init failed\n", st->id);
+		multi_stream_chain_release(st, MULTI_STREAM_CHAIN_BIND);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief 附加视频流的取流和推送线程
+ */
+static void *multi_stream_thread(void *arg)
+{
+	StreamState_S *st = (StreamState_S *)arg; // 当前视频流
+
+	// 降为普通调度策略，之后为本路创建的ISP、VENC和推流线程都会继承，不与主推流的实时线程竞争
+	RtProfile_S profile = {SCHED_OTHER, 0, -1};
+	rt_profile_apply_thread(&profile);
+
+	pthread_mutex_lock(&init_lock);
+	int ret = multi_stream_chain_init(st); // 建立链路
+	pthread_mutex_unlock(&init_lock);
+	if (ret != 0)
+	{
+		__atomic_store_n(&st->state, MULTI_STREAM_STATE_EXITED, __ATOMIC_RELEASE);
+		return NULL;
+	}
+	// 链路建立后才参与调度
+	__atomic_store_n(&st->state, MULTI_STREAM_STATE_ACTIVE, __ATOMIC_RELEASE);
+	printf("stream %u: camera %u %ux%u@%u %uMbps -> %s:%u, encoding at %ufps\n", st->id, st->cfg.cam_id, st->cfg.width, st->cfg.height,
+		   st->cfg.fps, st->cfg.bitrate, st->cfg.host_ip, st->cfg.host_port, multi_stream_dst_fps(st, st->applied_divisor));
+
+	VENC_STREAM_S stFrame;										  // 声明编码流结构
+	stFrame.pstPack = (VENC_PACK_S *)malloc(sizeof(VENC_PACK_S)); // 为编码包分配内存
+	FrameData_S frame;											  // 声明帧数据变量
+
+	while (__atomic_load_n(&st->running, __ATOMIC_RELAXED))
+	{
+		// 调度在主推流线程中只更新降频倍数，由本线程设置到编码通道
+		if (multi_stream_divisor(st) != st->applied_divisor)
+		{
+			multi_stream_apply(st);
+			printf("stream %u: primary latency guard set encoding to %ufps\n", st->id, multi_stream_dst_fps(st, st->applied_divisor));
+		}
+
+		if (RK_MPI_VENC_GetStream(st->id, &stFrame, MULTI_STREAM_GET_TIMEOUT_MS) != RK_SUCCESS)
+		{
+			continue; // 超时，检查是否需要停止
+		}
+
+		uint64_t now = multi_stream_now_us(); // 取得码流的时间
+		frame.buffer = (uint8_t *)RK_MPI_MB_Handle2VirAddr(stFrame.pstPack->pMbBlk);
+		frame.size = stFrame.pstPack->u32Len;
+		frame.pts = stFrame.pstPack->u64PTS;
+		gst_push_stream_data(st->id, &frame);
+		multi_stream_stats_add(st, now > frame.pts ? now - frame.pts : 0, frame.size);
+
+		if (RK_MPI_VENC_ReleaseStream(st->id, &stFrame) != RK_SUCCESS)
+		{
+			printf("stream %u: RK_MPI_VENC_ReleaseStream fail!\n", st->id);
+		}
+	}
+
+	__atomic_store_n(&st->state, MULTI_STREAM_STATE_EXITED, __ATOMIC_RELEASE);
+	free(stFrame.pstPack);
+	multi_stream_chain_release(st, MULTI_STREAM_CHAIN_GST);
+	return NULL;
+}
+
+/**
+ * @brief 启动一路附加视频流
+ */
+int multi_stream_start(const StreamConfig_S *cfg, EncondecType_E encodec_type, uint32_t param_sets_interval_ms)
+{
+	if (stream_count >= GST_PUSH_MAX_STREAMS)
+	{
+		printf("at most %d extra streams\n", MULTI_STREAM_MAX);
+		return -1;
+	}
+	for (uint8_t i = 1; i < stream_count; i++)
+	{
+		if (streams[i].cfg.cam_id == cfg->cam_id)
+		{
+			printf("camera %u is already used by stream %u\n", cfg->cam_id, i);
+			return -1;
+		}
+	}
+
+	StreamState_S *st = &streams[stream_count]; // 新的视频流
+	memset(st, 0, sizeof(StreamState_S));
+	st->cfg = *cfg;
+	st->id = stream_count;
+	st->encodec_type = encodec_type;
+	st->param_sets_interval_ms = param_sets_interval_ms;
+
+	// 按优先级分配编码器吞吐量：主推流和先启动的视频流优先，剩余吞吐量不足时降低本路的编码帧率
+	uint64_t used = 0; // 已分配的编码负载（像素/秒）
+	for (uint8_t i = 0; i < stream_count; i++)
+	{
+		used += multi_stream_load(&streams[i]);
+	}
+	st->divisor = 1;
+	while (st->divisor < MULTI_STREAM_MAX_DIVISOR && used + multi_stream_load(st) > encoder_capacity)
+	{
+		st->divisor *= 2;
+	}
+	if (used + multi_stream_load(st) > encoder_capacity)
+	{
+		printf("stream %u: encoder capacity exceeded even at %ufps\n", st->id, multi_stream_dst_fps(st, st->divisor));
+	}
+	st->admit_divisor = st->divisor;
+
+	// 有附加视频流时为主推流设置最高的编码优先级
+	if (stream_count == 1)
+	{
+		venc_set_chn_param(0, MULTI_STREAM_PRIMARY_PRIORITY, streams[0].cfg.fps, streams[0].cfg.fps);
+	}
+
+	// 线程创建前的写入对新线程可见；链路建立完成前状态为 STARTING，不参与调度
+	st->running = 1;
+	st->state = MULTI_STREAM_STATE_STARTING;
+	if (pthread_create(&st->thread, NULL, multi_stream_thread, st) != 0)
+	{
+		printf("stream %u: create thread failed\n", st->id);
+		return -1;
+	}
+	stream_count++;
+
+	return 0;
+}
+
+/**
+ * @brief 等待已启动的附加视频流完成链路建立
+ */
+int multi_stream_wait_ready(void)
+{
+	int active = 0; // 链路已建立的视频流数量
+
+	for (uint32_t waited_us = 0; waited_us < MULTI_STREAM_READY_TIMEOUT_MS * 1000; waited_us += MULTI_STREAM_READY_POLL_US)
+	{
+		int starting = 0; // 仍在建立链路的视频流数量
+		active = 0;
+		for (uint8_t i = 1; i < stream_count; i++)
+		{
+			int state = __atomic_load_n(&streams[i].state, __ATOMIC_ACQUIRE); // 线程状态
+			starting += state == MULTI_STREAM_STATE_STARTING;
+			active += state == MULTI_STREAM_STATE_ACTIVE;
+		}
+		if (starting == 0)
+		{
+			return active;
+		}
+		usleep(MULTI_STREAM_READY_POLL_US);
+	}
+
+	printf("timed out waiting for extra streams to start\n");
+	return active;
+}
+
+/**
+ * @brief 主推流延迟升高时降低优先级最低的附加视频流的帧率，恢复正常后再逐步恢复
+ */
+static void multi_stream_schedule(uint64_t window_avg_us)
+{
+	uint64_t frame_us = 1000000 / streams[0].cfg.fps; // 主推流的帧间隔
+
+	int all_throttled = 1; // 附加视频流是否都已降到最低帧率
+	for (uint8_t i = 1; i < stream_count; i++)
+	{
+		if (multi_stream_active(&streams[i]) && multi_stream_divisor(&streams[i]) < MULTI_STREAM_MAX_DIVISOR)
+		{
+			all_throttled = 0;
+		}
+	}
+
+	// 基准延迟取窗口平均延迟的最小值，并缓慢向窗口平均延迟靠拢，使场景或码率变化导致的主推流延迟升高最终计入基准；
+	// 附加视频流都已降到最低帧率时编码器争用最小，直接以当前窗口平均延迟作为基准
+	if (guard_baseline_us == 0 || window_avg_us < guard_baseline_us || all_throttled)
+	{
+		guard_baseline_us = window_avg_us;
+	}
+	else
+	{
+		guard_baseline_us += (window_avg_us - guard_baseline_us) / MULTI_STREAM_BASELINE_DECAY;
+	}
+
+	if (window_avg_us > guard_baseline_us + frame_us / 4)
+	{
+		// 编码器争用使主推流延迟增加超过1/4帧：从优先级最低的视频流开始降频
+		guard_good_windows = 0;
+		for (uint8_t i = stream_count - 1; i >= 1; i--)
+		{
+			uint8_t divisor = multi_stream_divisor(&streams[i]); // 当前的降频倍数
+			if (multi_stream_active(&streams[i]) && divisor < MULTI_STREAM_MAX_DIVISOR)
+			{
+				__atomic_store_n(&streams[i].divisor, divisor * 2, __ATOMIC_RELAXED);
+				break;
+			}
+		}
+	}
+	else if (window_avg_us <= guard_baseline_us + frame_us / 8 && ++guard_good_windows >= MULTI_STREAM_RELAX_WINDOWS)
+	{
+		// 主推流延迟持续正常：从优先级最高的视频流开始恢复，最多恢复到启动时分配的帧率
+		guard_good_windows = 0;
+		for (uint8_t i = 1; i < stream_count; i++)
+		{
+			uint8_t divisor = multi_stream_divisor(&streams[i]); // 当前的降频倍数
+			if (multi_stream_active(&streams[i]) && divisor > streams[i].admit_divisor)
+			{
+				__atomic_store_n(&streams[i].divisor, divisor / 2, __ATOMIC_RELAXED);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * @brief 记录主推流的一帧，并根据主推流延迟调整附加视频流的编码帧率
+ */
+void multi_stream_primary_frame(uint64_t latency_us, uint32_t size)
+{
+	multi_stream_stats_add(&streams[0], latency_us, size);
+
+	if (stream_count <= 1)
+	{
+		return; // 没有附加视频流，无需调度
+	}
+
+	guard_latency_sum += latency_us;
+	if (++guard_frames >= guard_window_frames)
+	{
+		multi_stream_schedule(guard_latency_sum / guard_frames);
+		guard_frames = 0;
+		guard_latency_sum = 0;
+	}
+}
+
+/**
+ * @brief 输出各路视频流的帧率、延迟和编码器占用率，并清零统计周期内的数据
+ */
+void multi_stream_report(void)
+{
+	uint64_t now = multi_stream_now_us();  // 当前时间
+	uint64_t elapsed = now - report_time_us; // 统计周期（微秒）
+	uint64_t encoded = 0;					 // 统计周期内编码的像素数
+	report_time_us = now;
+	if (elapsed == 0)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&stats_lock);
+	for (uint8_t i = 0; i < stream_count; i++)
+	{
+		StreamState_S *st = &streams[i];
+		StreamStats_S *stats = &st->stats;
+		printf("stream %u: %ux%u fps=%.1f/%u latency avg=%lluus max=%lluus rate=%llukbps%s\n", i, st->cfg.width, st->cfg.height,
+			   (double)stats->frames * 1000000 / elapsed, multi_stream_dst_fps(st, multi_stream_divisor(st)),
+			   (unsigned long long)(stats->frames ? stats->latency_sum / stats->frames : 0), (unsigned long long)stats->latency_max,
+			   (unsigned long long)(stats->bytes * 8 * 1000 / elapsed), i == 0 || __atomic_load_n(&st->state, __ATOMIC_ACQUIRE) != MULTI_STREAM_STATE_EXITED ? "" : " (stopped)");
+		encoded += (uint64_t)stats->frames * st->cfg.width * st->cfg.height;
+		memset(stats, 0, sizeof(StreamStats_S));
+	}
+	pthread_mutex_unlock(&stats_lock);
+
+	// 编码器占用率按实际编码的像素吞吐量与 -E 设定的编码器吞吐量之比估算，并非从编码器读取
+	if (encoder_capacity > 0)
+	{
+		printf("encoder utilization (estimate) %.1f%% (%.1f of assumed %.1f Mpixel/s, set by -E)\n", (double)encoded * 1000000 / elapsed * 100 / encoder_capacity,
+			   (double)encoded / elapsed, (double)encoder_capacity / 1000000);
+	}
+}
+
+/**
+ * @brief 停止全部附加视频流并释放其资源
+ */
+void multi_stream_stop(void)
+{
+	for (uint8_t i = 1; i < stream_count; i++)
+	{
+		__atomic_store_n(&streams[i].running, 0, __ATOMIC_RELAXED);
+	}
+	for (uint8_t i = 1; i < stream_count; i++)
+	{
+		pthread_join(streams[i].thread, NULL); // 链路建立失败的线程已自行退出
+	}
+	stream_count = 1;
+}
@@ -0,0 +1,147 @@
+#include <string.h>		// 引入memcmp、memcpy
+#include "param_sets.h" // 引入参数集缓存的声明
+
+/**
+ * @brief 查找下一个起始码 00 00 01
+ *
+ * @return const uint8_t* 起始码之后的第一个字节，未找到返回NULL
+ */
+static const uint8_t *find_start_code(const uint8_t *p, const uint8_t *end)
+{
+	while (end - p >= 3)
+	{
+		if (p[2] > 1)
+		{
+			p += 3; // 第三个字节大于1时，前三个位置都不可能是起始码的开头
+		}
+		else if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+		{
+			return p + 3;
+		}
+		else
+		{
+			p++;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief 重新拼接带起始码的参数集
+ */
+static void param_sets_rebuild(ParamSets_S *ps)
+{
+	static const uint8_t start_code[4] = {0, 0, 0, 1};
+
+	ps->annexb_size = 0;
+	for (int i = ps->h265 ? ParamSetType_E_VPS : ParamSetType_E_SPS; i < ParamSetType_E_COUNT; i++)
+	{
+		if (ps->nal_size[i] == 0)
+		{
+			ps->annexb_size = 0; // 参数集不完整
+			return;
+		}
+		memcpy(ps->annexb + ps->annexb_size, start_code, sizeof(start_code));
+		memcpy(ps->annexb + ps->annexb_size + sizeof(start_code), ps->nal[i], ps->nal_size[i]);
+		ps->annexb_size += sizeof(start_code) + ps->nal_size[i];
+	}
+}
+
+/**
+ * @brief 初始化参数集缓存
+ */
+void param_sets_init(ParamSets_S *ps, int h265)
+{
+	memset(ps, 0, sizeof(*ps));
+	ps->h265 = h265;
+}
+
+/**
+ * @brief 扫描一帧 Annex B 码流开头的非VCL NAL单元，更新参数集缓存
+ */
+int param_sets_scan(ParamSets_S *ps, const uint8_t *buf, size_t size)
+{
+	const uint8_t *end = buf + size; // 帧数据结尾
+	const uint8_t *nal = find_start_code(buf, end); // 当前NAL单元
+	int flags = 0;					  // 帧标志
+	int changed = 0;				  // 参数集是否有更新
+	int present = 0;				  // 帧中出现的参数集种类（按位）
+
+	while (nal != NULL && nal < end)
+	{
+		// 先判断NAL类型，遇到第一个条带即停止，不再向后查找起始码
+		int type; // 参数集种类，-1 表示不是参数集
+		if (ps->h265)
+		{
+			int nal_type = (nal[0] >> 1) & 0x3f;
+			if (nal_type < 32)
+			{
+				if (nal_type >= 16 && nal_type <= 21)
+				{
+					flags |= PARAM_SETS_FRAME_IRAP; // BLA、IDR、CRA
+				}
+				break; // 第一个条带，之后不会再有参数集
+			}
+			type = nal_type == 32 ? ParamSetType_E_VPS : nal_type == 33 ? ParamSetType_E_SPS : nal_type == 34 ? ParamSetType_E_PPS : -1;
+		}
+		else
+		{
+			int nal_type = nal[0] & 0x1f;
+			if (nal_type >= 1 && nal_type <= 5)
+			{
+				if (nal_type == 5)
+				{
+					flags |= PARAM_SETS_FRAME_IRAP; // IDR
+				}
+				break; // 第一个条带，之后不会再有参数集
+			}
+			type = nal_type == 7 ? ParamSetType_E_SPS : nal_type == 8 ? ParamSetType_E_PPS : -1;
+		}
+
+		const uint8_t *next = find_start_code(nal, end); // 下一个NAL单元，只在参数集等较小的非VCL单元内查找
+		const uint8_t *nal_end = next != NULL ? next - 3 : end;
+		while (nal_end > nal && nal_end[-1] == 0)
+		{
+			nal_end--; // 去掉4字节起始码的前导0
+		}
+
+		uint32_t len = (uint32_t)(nal_end - nal); // NAL单元长度
+		if (type >= 0 && len > 0 && len <= PARAM_SETS_MAX_NAL)
+		{
+			present |= 1 << type;
+			if (len != ps->nal_size[type] || memcmp(ps->nal[type], nal, len) != 0)
+			{
+				memcpy(ps->nal[type], nal, len);
+				ps->nal_size[type] = len;
+				changed = 1;
+			}
+		}
+
+		nal = next;
+	}
+
+	// 只有该编码所需的参数集全部出现时，才认为帧已自带参数集
+	int required = ps->h265 ? (1 << ParamSetType_E_VPS) | (1 << ParamSetType_E_SPS) | (1 << ParamSetType_E_PPS)
+							: (1 << ParamSetType_E_SPS) | (1 << ParamSetType_E_PPS);
+	if ((present & required) == required)
+	{
+		flags |= PARAM_SETS_FRAME_PARAMS;
+	}
+
+	if (changed)
+	{
+		param_sets_rebuild(ps);
+	}
+
+	return flags;
+}
+
+/**
+ * @brief 获取带起始码的完整参数集
+ */
+const uint8_t *param_sets_get(const ParamSets_S *ps, uint32_t *size)
+{
+	*size = ps->annexb_size;
+	return ps->annexb_size > 0 ? ps->annexb : NULL;
+}
@@ -0,0 +1,197 @@
+#define _GNU_SOURCE
+#include <stdio.h>		// 引入标准输入输出库，支持打印功能
+#include <stdlib.h>		// 引入atoi
+#include <string.h>		// 引入字符串处理库
+#include <errno.h>		// 引入错误码定义
+#include <pthread.h>	// 引入线程调度接口
+#include <sched.h>		// 引入调度策略和CPU亲和性接口
+#include <sys/mman.h>	// 引入mlockall
+#include "rt_profile.h" // 引入实时调度配置的声明
+
+#ifndef MCL_ONFAULT
+#define MCL_ONFAULT 4 // Linux 4.4 起支持，旧的 C 库头文件中可能没有定义
+#endif
+
+#define RT_PROFILE_STACK_PREFAULT (64 * 1024) // 预先访问的当前线程栈大小，热路径的栈不超过该大小
+
+// 抖动直方图各区间的上限（微秒），最后一个区间为超过上一个上限的所有值
+static const uint32_t jitter_bin_limits[JITTER_BINS - 1] = {100, 250, 500, 1000, 2000, 5000, 10000};
+
+/**
+ * @brief 解析形如 "fifo:50"、"rr:10" 或 "other" 的调度配置
+ */
+int rt_profile_parse(const char *arg, RtProfile_S *profile)
+{
+	const char *sep = strchr(arg, ':');				   // 策略与优先级的分隔符
+	size_t len = sep ? (size_t)(sep - arg) : strlen(arg); // 策略名称长度
+
+	if (strncmp(arg, "fifo", len) == 0 && len == 4)
+	{
+		profile->policy = SCHED_FIFO;
+	}
+	else if (strncmp(arg, "rr", len) == 0 && len == 2)
+	{
+		profile->policy = SCHED_RR;
+	}
+	else if (strncmp(arg, "other", len) == 0 && len == 5)
+	{
+		profile->policy = SCHED_OTHER;
+	}
+	else
+	{
+		return -1;
+	}
+
+	profile->priority = sep ? atoi(sep + 1) : 0;
+	if (profile->policy == SCHED_OTHER)
+	{
+		profile->priority = 0; // SCHED_OTHER 不使用实时优先级
+	}
+	else if (profile->priority < sched_get_priority_min(profile->policy) || profile->priority > sched_get_priority_max(profile->policy))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief 将调度策略、优先级和CPU绑定应用到当前线程
+ *
+ * @details 之后由当前线程创建的线程会继承调度策略和CPU绑定。
+ */
+int rt_profile_apply_thread(const RtProfile_S *profile)
+{
+	struct sched_param param; // 调度参数
+	int ret;				  // 返回值
+
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = profile->priority;
+	ret = pthread_setschedparam(pthread_self(), profile->policy, &param);
+	if (ret != 0)
+	{
+		printf("pthread_setschedparam policy=%d priority=%d failed: %s\n", profile->policy, profile->priority, strerror(ret));
+		return -1;
+	}
+
+	if (profile->cpu >= 0)
+	{
+		cpu_set_t cpuset; // CPU集合
+		CPU_ZERO(&cpuset);
+		CPU_SET(profile->cpu, &cpuset);
+		if (sched_setaffinity(0, sizeof(cpuset), &cpuset) != 0)
+		{
+			printf("sched_setaffinity cpu=%d failed: %s\n", profile->cpu, strerror(errno));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief 访问当前线程栈顶之下的一段栈空间，使之后调用 mlockall() 时这段栈已驻留并被锁定
+ */
+static void __attribute__((noinline)) rt_profile_prefault_stack(void)
+{
+	volatile uint8_t stack[RT_PROFILE_STACK_PREFAULT]; // 预先访问的栈空间
+
+	for (size_t i = 0; i < sizeof(stack); i += 4096)
+	{
+		stack[i] = 0;
+	}
+}
+
+/**
+ * @brief 锁定进程已驻留和之后访问到的内存，避免热路径上发生缺页
+ *
+ * @details 使用 MCL_ONFAULT 而不是 MCL_FUTURE：已映射但尚未访问的区域（如各线程的8MB栈、其他线程的堆区）
+ * 只在实际访问到时才锁定，不会一次性全部调入内存；之后新建的映射（线程栈、新的堆区）不锁定，
+ * 不会与内存预算模式争用内存，也不会因锁定内存超限而映射失败。当前线程的栈预先访问，确保热路径上已锁定。
+ */
+int rt_profile_lock_memory(void)
+{
+	rt_profile_prefault_stack();
+	if (mlockall(MCL_CURRENT | MCL_ONFAULT) != 0)
+	{
+		printf("mlockall failed: %s\n", strerror(errno)); // 内核不支持 MCL_ONFAULT 时不锁定，避免调入全部映射
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief 初始化帧间隔抖动统计
+ */
+void jitter_stats_init(JitterStats_S *stats, uint8_t fps)
+{
+	memset(stats, 0, sizeof(JitterStats_S));				// 清零统计结构体
+	stats->expected_us = 1000000 / (fps ? fps : 30); // 期望的帧间隔
+}
+
+/**
+ * @brief 记录一帧的到达时间
+ */
+void jitter_stats_add(JitterStats_S *stats, uint64_t now_us)
+{
+	if (stats->last_us != 0)
+	{
+		int64_t interval = (int64_t)(now_us - stats->last_us);					// 实际帧间隔
+		uint32_t deviation = (uint32_t)llabs(interval - (int64_t)stats->expected_us); // 与期望间隔的偏差
+		int bin = 0;															// 直方图区间
+
+		while (bin < JITTER_BINS - 1 && deviation >= jitter_bin_limits[bin])
+		{
+			bin++;
+		}
+		stats->bins[bin]++;
+		stats->count++;
+		stats->sum_us += deviation;
+		if (deviation > stats->max_us)
+		{
+			stats->max_us = deviation;
+		}
+	}
+	stats->last_us = now_us;
+}
+
+/**
+ * @brief 输出抖动直方图并清零统计周期内的数据
+ */
+void jitter_stats_report(JitterStats_S *stats)
+{
+	if (stats->count == 0)
+	{
+		return;
+	}
+
+	// 由直方图估计 99 分位的区间上限
+	uint32_t p99_target = stats->count - stats->count / 100;
+	uint32_t accumulated = 0;
+	int p99_bin = 0;
+	for (p99_bin = 0; p99_bin < JITTER_BINS - 1; p99_bin++)
+	{
+		accumulated += stats->bins[p99_bin];
+		if (accumulated >= p99_target)
+		{
+			break;
+		}
+	}
+
+	printf("jitter expected=%uus frames=%u avg=%lluus max=%uus p99<%s%uus\n",
+		   stats->expected_us, stats->count, (unsigned long long)(stats->sum_us / stats->count), stats->max_us,
+		   p99_bin < JITTER_BINS - 1 ? "" : ">=", jitter_bin_limits[p99_bin < JITTER_BINS - 1 ? p99_bin : JITTER_BINS - 2]);
+	printf("jitter histogram:");
+	for (int i = 0; i < JITTER_BINS - 1; i++)
+	{
+		printf(" <%uus:%u", jitter_bin_limits[i], stats->bins[i]);
+	}
+	printf(" >=%uus:%u\n", jitter_bin_limits[JITTER_BINS - 2], stats->bins[JITTER_BINS - 1]);
+
+	// 清零统计周期内的数据，保留上一帧时间以便连续统计
+	stats->count = 0;
+	stats->sum_us = 0;
+	stats->max_us = 0;
+	memset(stats->bins, 0, sizeof(stats->bins));
+}
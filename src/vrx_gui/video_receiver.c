@@ -3,79 +3,893 @@
 #include <gst/gst.h>                // 包含GStreamer库的头文件，用于处理多媒体流。
 #include <gst/video/videooverlay.h> // 包含处理视频叠加的GStreamer头文件。
 #include <stdio.h>                  // 包含标准输入输出库，提供printf等函数的功能。
+#include <stdlib.h>                 // 包含标准库，提供atoi、exit等函数。
 #include <string.h>                 // 包含字符串处理库，提供字符串操作的功能。
+#include <unistd.h>                 // 包含POSIX接口，提供getopt、sysconf等函数。
+#include <math.h>                   // 包含数学库，提供ceil、sqrt等函数。
+#include <sys/syscall.h>            // 包含系统调用号定义，用于获取线程ID。
+#include <sys/resource.h>           // 包含资源统计接口，用于获取进程CPU时间。
+#include <time.h>                   // 包含clock_gettime，用于获取线程CPU时间。
 
-// 定义一个全局变量用于窗口
-Window win;
+#define MAX_STREAMS 8          // 最大同时接收的视频流数量
+#define DEFAULT_PORT 5600      // 默认UDP端口
+#define DEFAULT_CODEC "h265"   // 默认视频编码方式
+#define MOSAIC_CELL_WIDTH 640  // 拼接模式下每个画面的宽度
+#define MOSAIC_CELL_HEIGHT 360 // 拼接模式下每个画面的高度
+#define STATS_INTERVAL_MS 1000 // 统计信息输出间隔（毫秒）
+#define OUTAGE_MS 500          // 超过该时间未收到RTP包视为链路中断（毫秒）
+#define PARAM_SET_COUNT 3      // 缓存的参数集种类数：VPS、SPS、PPS
+
+// 枚举类型，用于表示解码输出到屏幕的显示路径
+typedef enum
+{
+    RenderMode_E_AUTO = 0, // 依次尝试gl、xv、x
+    RenderMode_E_GL,       // glimagesink直接接收YUV，在着色器中转换颜色
+    RenderMode_E_XV,       // xvimagesink以平面YUV直接显示，由显卡叠加层缩放
+    RenderMode_E_X,        // videoconvert + ximagesink，无GPU时的软件显示路径
+    RenderMode_E_CONVERT,  // videoconvert + glimagesink，原有的显示路径，用于对比
+    RenderMode_E_COUNT
+} RenderMode_E;
+
+static const char *render_mode_names[RenderMode_E_COUNT] = {"auto", "gl", "xv", "x", "convert"};
+
+// 定义一个结构体，用于统计显示线程中每帧颜色转换和显示消耗的CPU时间
+typedef struct
+{
+    gint64 start_ns;       // 当前帧进入显示路径时的线程CPU时间
+    gint64 mark_ns;        // 当前帧颜色转换结束（或进入显示路径）时的线程CPU时间
+    gint64 convert_ns_sum; // 统计周期内颜色转换的CPU时间累计值
+    gint64 render_ns_sum;  // 统计周期内显示的CPU时间累计值
+    gint64 mix_start_ns;   // 拼接模式下合成器开始合成当前帧时的线程CPU时间
+    gint64 mix_ns_sum;     // 统计周期内合成（缩放、混合）的CPU时间累计值
+    gint frames;           // 统计周期内显示的帧数
+    GMutex lock;           // 保护统计数据的互斥锁
+} RenderStats_S;
+
+// 定义一个结构体，用于描述单路视频流及其统计信息
+typedef struct
+{
+    int port;                 // UDP监听端口
+    gboolean h265;            // TRUE为H265，FALSE为H264
+    int decoder_threads;      // 分配给该路解码器的线程数
+    Window win;               // 该路流使用的X11窗口（拼接模式下不使用）
+    gint frames;              // 统计周期内解码输出的帧数
+    gint64 latency_sum_ns;    // 统计周期内的延迟累计值（纳秒）
+    gint64 latency_max_ns;    // 统计周期内的最大延迟（纳秒）
+    gint ingress_tid;         // 接收/解码线程的线程ID
+    gint render_tid;          // 显示线程的线程ID
+    guint64 ingress_cpu_last; // 上一次统计时接收/解码线程的CPU时间（时钟滴答）
+    guint64 render_cpu_last;  // 上一次统计时显示线程的CPU时间（时钟滴答）
+    gint64 last_packet_us;    // 最近一次收到RTP包的时间，0 表示尚未收到
+    gint64 join_us;           // 加入或链路恢复的时间，用于计算首帧时间
+    gboolean after_outage;    // 本次等待首帧是否由链路中断引起
+    gboolean waiting_picture; // 是否在等待加入或恢复后的第一帧完整画面
+    gchar *param_sets[PARAM_SET_COUNT]; // 最近收到的参数集（Base64），H264不使用VPS
+    RenderStats_S render_stats; // 独立窗口模式下显示路径的CPU时间统计
+    GMutex lock;              // 保护统计数据的互斥锁
+} StreamCtx_S;
+
+// 定义全局变量
+Window win;                          // 单窗口/拼接模式使用的窗口
+StreamCtx_S streams[MAX_STREAMS];    // 所有视频流
+int stream_count = 0;                // 视频流数量
+gboolean mosaic = FALSE;             // 是否使用拼接模式（所有流显示在同一窗口）
+GstElement *gst_pipeline = NULL;     // 全局GStreamer管道，所有流共用
+RenderMode_E render_mode = RenderMode_E_AUTO; // 命令行指定的显示路径
+RenderMode_E active_render_mode;     // 实际使用的显示路径
+RenderStats_S mosaic_render_stats;   // 拼接模式下显示路径的CPU时间统计
+volatile gboolean stats_running = 0; // 统计线程运行标志
+
+/**
+ * @brief 获取当前线程的内核线程ID。
+ *
+ * @return gint 线程ID。
+ */
+static gint get_tid(void)
+{
+    return (gint)syscall(SYS_gettid);
+}
 
 /**
- * @brief 初始化GStreamer管道以播放通过UDP接收的H265视频流。
+ * @brief 读取指定线程已消耗的CPU时间。
  *
- * @details 此函数创建一个GStreamer管道，包括源、解封装器、解析器、解码器、转换器和输出显示效果器。
- * 它将数据从UDP端口5600接收，并通过X11窗口播放视频流。
+ * @param tid 线程ID，为0时返回0。
  *
- * @return 无输出参数。
+ * @return guint64 用户态加内核态CPU时间，单位为时钟滴答。
  */
-void initGst2(void)
+static guint64 read_thread_cpu_ticks(gint tid)
 {
-    // 创建GStreamer元素，包括管道和各个组件的指针
-    GstElement *gst_pipeline;    // GStreamer管道，包含所有处理元素
-    GstElement *gst_src;         // UDP源元素
-    GstElement *gst_depayloader; // RTP解封装器
-    GstElement *gst_parser;      // H265解析器
-    GstElement *gst_decoder;     // H265解码器
-    GstElement *gst_conv;        // 视频转换元素
-    GstElement *gst_sink;        // 视频输出元素
-    GstElement *queue;           // 用于缓冲帧的队列元素
+    char path[64];
+    char buf[512];
+    unsigned long utime = 0, stime = 0;
 
-    // 创建一个新的GStreamer管道
-    gst_pipeline = gst_pipeline_new("xvoverlay");
+    if (tid == 0)
+    {
+        return 0;
+    }
+
+    snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return 0;
+    }
+    size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+    fclose(fp);
+    buf[len] = '\0';
+
+    // 线程名可能包含空格，从最后一个')'之后开始解析，utime和stime分别为第14、15个字段
+    char *p = strrchr(buf, ')');
+    if (p == NULL || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2)
+    {
+        return 0;
+    }
+
+    return (guint64)utime + stime;
+}
+
+/**
+ * @brief 接收端的pad探针，记录接收/解码线程ID，并检测加入和链路中断后的恢复。
+ */
+static GstPadProbeReturn ingress_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    StreamCtx_S *stream = (StreamCtx_S *)user_data;
+    gint64 now = g_get_monotonic_time();
+
+    if (g_atomic_int_get(&stream->ingress_tid) == 0)
+    {
+        g_atomic_int_set(&stream->ingress_tid, get_tid()); // 首次进入时记录线程ID
+    }
+
+    // 收到第一个包或中断后恢复时，开始计算到第一帧画面的时间
+    if (stream->last_packet_us == 0 || now - stream->last_packet_us > OUTAGE_MS * 1000)
+    {
+        g_mutex_lock(&stream->lock);
+        stream->join_us = now;
+        stream->after_outage = stream->last_packet_us != 0;
+        stream->waiting_picture = TRUE;
+        g_mutex_unlock(&stream->lock);
+    }
+    stream->last_packet_us = now;
+
+    return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief 参数集缓存文件的路径。
+ *
+ * @return gchar* 需要用g_free释放。
+ */
+static gchar *param_sets_cache_path(const StreamCtx_S *stream)
+{
+    gchar name[32];
+    snprintf(name, sizeof(name), "%d-%s.sprop", stream->port, stream->h265 ? "h265" : "h264");
+    return g_build_filename(g_get_user_cache_dir(), "video_receiver", name, NULL);
+}
+
+/**
+ * @brief 从缓存文件读取上次收到的参数集。
+ */
+static void param_sets_load(StreamCtx_S *stream)
+{
+    static const char *keys[PARAM_SET_COUNT] = {"vps", "sps", "pps"};
+    gchar *path = param_sets_cache_path(stream);
+    GKeyFile *key_file = g_key_file_new();
+
+    if (g_key_file_load_from_file(key_file, path, G_KEY_FILE_NONE, NULL))
+    {
+        for (int i = 0; i < PARAM_SET_COUNT; i++)
+        {
+            g_free(stream->param_sets[i]);
+            stream->param_sets[i] = g_key_file_get_string(key_file, "sprop", keys[i], NULL);
+        }
+    }
+
+    g_key_file_free(key_file);
+    g_free(path);
+}
+
+/**
+ * @brief 将参数集保存到缓存文件，供下次启动时预置解封装器。
+ */
+static void param_sets_save(StreamCtx_S *stream)
+{
+    static const char *keys[PARAM_SET_COUNT] = {"vps", "sps", "pps"};
+    gchar *path = param_sets_cache_path(stream);
+    gchar *dir = g_path_get_dirname(path);
+    GKeyFile *key_file = g_key_file_new();
+
+    for (int i = 0; i < PARAM_SET_COUNT; i++)
+    {
+        if (stream->param_sets[i] != NULL)
+        {
+            g_key_file_set_string(key_file, "sprop", keys[i], stream->param_sets[i]);
+        }
+    }
+    gsize len;
+    gchar *data = g_key_file_to_data(key_file, &len, NULL);
+    g_mkdir_with_parents(dir, 0755);
+    if (!g_file_set_contents(path, data, len, NULL))
+    {
+        printf("save parameter sets to %s error!\r\n", path);
+    }
+
+    g_free(data);
+    g_key_file_free(key_file);
+    g_free(dir);
+    g_free(path);
+}
+
+/**
+ * @brief 查找下一个起始码 00 00 01。
+ *
+ * @return const guint8* 起始码之后的第一个字节，未找到返回NULL。
+ */
+static const guint8 *find_start_code(const guint8 *p, const guint8 *end)
+{
+    while (end - p >= 3)
+    {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+        {
+            return p + 3;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 解封装输出端的pad探针，缓存帧开头的参数集。
+ *
+ * @details 参数集总是位于帧内第一个条带之前，扫描到第一个条带即停止；只有参数集变化时才写缓存文件。
+ */
+static GstPadProbeReturn param_sets_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    StreamCtx_S *stream = (StreamCtx_S *)user_data;
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    GstMapInfo map;
+    gboolean changed = FALSE;
+
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ))
+    {
+        return GST_PAD_PROBE_OK;
+    }
+
+    const guint8 *end = map.data + map.size;
+    const guint8 *nal = find_start_code(map.data, end);
+    while (nal != NULL && nal < end)
+    {
+        // 先判断NAL类型，遇到第一个条带即停止，之后的条带数据不再扫描
+        int type = -1; // 参数集种类：0为VPS，1为SPS，2为PPS
+        if (stream->h265)
+        {
+            int nal_type = (nal[0] >> 1) & 0x3f;
+            if (nal_type < 32)
+            {
+                break;
+            }
+            type = (nal_type >= 32 && nal_type <= 34) ? nal_type - 32 : -1;
+        }
+        else
+        {
+            int nal_type = nal[0] & 0x1f;
+            if (nal_type >= 1 && nal_type <= 5)
+            {
+                break;
+            }
+            type = (nal_type == 7 || nal_type == 8) ? nal_type - 6 : -1;
+        }
+
+        // 查找下一个起始码，得到当前NAL单元的结尾
+        const guint8 *next = find_start_code(nal, end);
+        const guint8 *nal_end = next != NULL ? next - 3 : end;
+        while (nal_end > nal && nal_end[-1] == 0)
+        {
+            nal_end--; // 去掉4字节起始码的前导0
+        }
+
+        if (type >= 0 && nal_end > nal)
+        {
+            gchar *b64 = g_base64_encode(nal, nal_end - nal);
+            if (g_strcmp0(b64, stream->param_sets[type]) != 0)
+            {
+                g_free(stream->param_sets[type]);
+                stream->param_sets[type] = b64;
+                changed = TRUE;
+            }
+            else
+            {
+                g_free(b64);
+            }
+        }
+        nal = next;
+    }
+    gst_buffer_unmap(buffer, &map);
+
+    if (changed)
+    {
+        param_sets_save(stream);
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief 获取当前线程已消耗的CPU时间。
+ *
+ * @return gint64 CPU时间，单位为纳秒。
+ */
+static gint64 thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (gint64)ts.tv_sec * GST_SECOND + ts.tv_nsec;
+}
 
-    // 创建UDP源，监听127.0.0.1:5600
-    gst_src = gst_element_factory_make("udpsrc", "source");
-    g_object_set(G_OBJECT(gst_src), "port", 5600, NULL); // 设置UDP端口为5600
-    g_object_set(G_OBJECT(gst_src), "caps", gst_caps_new_simple("application/x-rtp", "media", G_TYPE_STRING, "video", "encoding-name", G_TYPE_STRING, "H265", NULL), NULL);
-    // 调整缓冲区大小和延迟以提高实时性能
+/**
+ * @brief 合成器选定本帧输入后、开始合成前发出的samples-selected信号回调，记录合成开始时间。
+ *
+ * @details 合成器在自己的输出线程中先合成本帧、再推送给显示路径，该回调与显示路径探针在同一线程中，
+ * 用于把合成的CPU时间从上一帧的显示开销中分离出来。
+ */
+static void mix_start_cb(GstElement *aggregator, GstSegment *segment, guint64 pts, guint64 dts, guint64 duration, GstStructure *info, gpointer user_data)
+{
+    RenderStats_S *stats = (RenderStats_S *)user_data;
+    gint64 now = thread_cpu_ns();
+
+    g_mutex_lock(&stats->lock);
+    stats->mix_start_ns = now;
+    g_mutex_unlock(&stats->lock);
+}
+
+/**
+ * @brief 显示路径入口的pad探针，帧进入颜色转换/显示元素之前调用。
+ *
+ * @details 显示路径在同一个流线程中运行，上一帧颜色转换结束到本帧进入之间的线程CPU时间
+ * 即为上一帧的显示开销；线程等待期间不计入CPU时间。
+ * 拼接模式下这段时间还包含本帧的合成，以合成开始时间为界分开统计。
+ */
+static GstPadProbeReturn render_start_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    RenderStats_S *stats = (RenderStats_S *)user_data;
+    gint64 now = thread_cpu_ns();
+
+    g_mutex_lock(&stats->lock);
+    if (stats->mark_ns != 0)
+    {
+        // 合成开始时间早于上一帧显示结束时，说明本帧没有经过合成器
+        gint64 render_end_ns = (stats->mix_start_ns > stats->mark_ns) ? stats->mix_start_ns : now;
+        stats->render_ns_sum += render_end_ns - stats->mark_ns;
+        stats->mix_ns_sum += now - render_end_ns;
+        stats->frames++;
+    }
+    stats->start_ns = now;
+    stats->mark_ns = now;
+    g_mutex_unlock(&stats->lock);
+
+    return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief 颜色转换输出端的pad探针，统计本帧颜色转换的CPU时间。
+ */
+static GstPadProbeReturn convert_done_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    RenderStats_S *stats = (RenderStats_S *)user_data;
+    gint64 now = thread_cpu_ns();
+
+    g_mutex_lock(&stats->lock);
+    if (stats->start_ns != 0)
+    {
+        stats->convert_ns_sum += now - stats->start_ns;
+    }
+    stats->mark_ns = now;
+    g_mutex_unlock(&stats->lock);
+
+    return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief 输出并清零显示路径的CPU时间统计。
+ */
+static void print_render_stats(const char *label, RenderStats_S *stats)
+{
+    g_mutex_lock(&stats->lock);
+    gint frames = stats->frames;
+    gint64 convert_sum = stats->convert_ns_sum;
+    gint64 render_sum = stats->render_ns_sum;
+    gint64 mix_sum = stats->mix_ns_sum;
+    stats->frames = 0;
+    stats->convert_ns_sum = 0;
+    stats->render_ns_sum = 0;
+    stats->mix_ns_sum = 0;
+    g_mutex_unlock(&stats->lock);
+
+    printf("render %s path=%s mix_cpu=%.3fms/frame convert_cpu=%.3fms/frame render_cpu=%.3fms/frame\n",
+           label, render_mode_names[active_render_mode],
+           frames ? (double)mix_sum / frames / GST_MSECOND : 0.0,
+           frames ? (double)convert_sum / frames / GST_MSECOND : 0.0,
+           frames ? (double)render_sum / frames / GST_MSECOND : 0.0);
+}
+
+/**
+ * @brief 解码输出端的pad探针，统计帧率和接收到显示前的延迟。
+ *
+ * @details udpsrc会以到达时的running time为缓冲区打时间戳，解封装和解码过程保留该时间戳，
+ * 因此当前running time与PTS之差即为该帧从最后一个RTP包到达到解码完成的延迟。
+ */
+static GstPadProbeReturn render_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    StreamCtx_S *stream = (StreamCtx_S *)user_data;
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    gint64 latency = -1;
+
+    if (g_atomic_int_get(&stream->render_tid) == 0)
+    {
+        g_atomic_int_set(&stream->render_tid, get_tid()); // 首次进入时记录线程ID
+    }
+
+    GstClock *clock = gst_element_get_clock(gst_pipeline);
+    if (clock != NULL && GST_BUFFER_PTS_IS_VALID(buffer))
+    {
+        GstClockTime running_time = gst_clock_get_time(clock) - gst_element_get_base_time(gst_pipeline);
+        if (running_time > GST_BUFFER_PTS(buffer))
+        {
+            latency = (gint64)(running_time - GST_BUFFER_PTS(buffer));
+        }
+    }
+    if (clock != NULL)
+    {
+        gst_object_unref(clock);
+    }
+
+    g_mutex_lock(&stream->lock);
+    if (stream->waiting_picture && !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_CORRUPTED))
+    {
+        // 加入或链路恢复后的第一帧完整画面
+        stream->waiting_picture = FALSE;
+        printf("stream port=%d first picture %.1fms after %s\n", stream->port,
+               (double)(g_get_monotonic_time() - stream->join_us) / 1000, stream->after_outage ? "link outage" : "join");
+    }
+    stream->frames++;
+    if (latency >= 0)
+    {
+        stream->latency_sum_ns += latency;
+        if (latency > stream->latency_max_ns)
+        {
+            stream->latency_max_ns = latency;
+        }
+    }
+    g_mutex_unlock(&stream->lock);
+
+    return GST_PAD_PROBE_OK;
+}
+
+/**
+ * @brief 统计线程，周期性输出每路流的帧率、延迟和CPU占用。
+ *
+ * @details 每路流的CPU占用为其接收/解码线程和显示线程之和；解码器内部的工作线程无法归属到
+ * 具体某一路流，只计入进程总CPU占用中。
+ */
+static gpointer stats_thread(gpointer data)
+{
+    long ticks_per_sec = sysconf(_SC_CLK_TCK);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    gint64 process_cpu_last = (gint64)usage.ru_utime.tv_sec * G_USEC_PER_SEC + usage.ru_utime.tv_usec + (gint64)usage.ru_stime.tv_sec * G_USEC_PER_SEC + usage.ru_stime.tv_usec;
+    gint64 wall_last = g_get_monotonic_time();
+
+    while (stats_running)
+    {
+        g_usleep(STATS_INTERVAL_MS * 1000);
+
+        gint64 wall_now = g_get_monotonic_time();
+        double elapsed = (double)(wall_now - wall_last) / G_USEC_PER_SEC;
+        wall_last = wall_now;
+
+        for (int i = 0; i < stream_count; i++)
+        {
+            StreamCtx_S *stream = &streams[i];
+
+            g_mutex_lock(&stream->lock);
+            gint frames = stream->frames;
+            gint64 latency_sum = stream->latency_sum_ns;
+            gint64 latency_max = stream->latency_max_ns;
+            stream->frames = 0;
+            stream->latency_sum_ns = 0;
+            stream->latency_max_ns = 0;
+            g_mutex_unlock(&stream->lock);
+
+            guint64 ingress_cpu = read_thread_cpu_ticks(g_atomic_int_get(&stream->ingress_tid));
+            guint64 render_cpu = read_thread_cpu_ticks(g_atomic_int_get(&stream->render_tid));
+            guint64 cpu_ticks = (ingress_cpu - stream->ingress_cpu_last) + (render_cpu - stream->render_cpu_last);
+            stream->ingress_cpu_last = ingress_cpu;
+            stream->render_cpu_last = render_cpu;
+
+            printf("stream %d port=%d %s fps=%.1f latency_avg=%.2fms latency_max=%.2fms cpu=%.1f%%\n",
+                   i, stream->port, stream->h265 ? "h265" : "h264",
+                   frames / elapsed,
+                   frames ? (double)latency_sum / frames / GST_MSECOND : 0.0,
+                   (double)latency_max / GST_MSECOND,
+                   100.0 * cpu_ticks / ticks_per_sec / elapsed);
+            if (!mosaic)
+            {
+                char label[32];
+                snprintf(label, sizeof(label), "port=%d", stream->port);
+                print_render_stats(label, &stream->render_stats);
+            }
+        }
+        if (mosaic)
+        {
+            print_render_stats("mosaic", &mosaic_render_stats);
+        }
+
+        getrusage(RUSAGE_SELF, &usage);
+        gint64 process_cpu = (gint64)usage.ru_utime.tv_sec * G_USEC_PER_SEC + usage.ru_utime.tv_usec + (gint64)usage.ru_stime.tv_sec * G_USEC_PER_SEC + usage.ru_stime.tv_usec;
+        printf("total cpu=%.1f%% (including decoder worker threads)\n", 100.0 * (process_cpu - process_cpu_last) / G_USEC_PER_SEC / elapsed);
+        process_cpu_last = process_cpu;
+        fflush(stdout);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 创建显示路径并连接到上游元素。
+ *
+ * @details gl路径由glimagesink直接接收解码输出的I420/NV12，在着色器中完成颜色转换，CPU上没有转换；
+ * xv和x路径保留videoconvert，格式匹配时（如xvimagesink接收I420）videoconvert工作在直通模式，不产生拷贝。
+ * 拼接模式下gl路径的上游是glvideomixer，输出已是GL纹理；其他路径的上游是compositor，缩放和混合在CPU上完成，
+ * 不属于零拷贝显示。
+ * 所有路径均关闭按时钟同步，解码完成即显示。
+ *
+ * @param upstream 上游元素（独立窗口模式下为队列，拼接模式下为合成器）
+ * @param window 显示使用的X11窗口
+ * @param mode 显示路径，不能为RenderMode_E_AUTO
+ * @param stats 显示路径的CPU时间统计
+ *
+ * @return int 返回0表示成功，返回-1表示失败
+ */
+static int add_render_chain(GstElement *upstream, Window window, RenderMode_E mode, RenderStats_S *stats)
+{
+    gboolean need_convert = mode != RenderMode_E_GL; // 是否需要CPU颜色转换元素
+    const char *sink_factory = (mode == RenderMode_E_XV) ? "xvimagesink" : (mode == RenderMode_E_X) ? "ximagesink" : "glimagesink";
+
+    GstElement *gst_conv = need_convert ? gst_element_factory_make("videoconvert", NULL) : NULL;
+    GstElement *gst_sink = gst_element_factory_make(sink_factory, NULL);
+    if (gst_sink == NULL || (need_convert && gst_conv == NULL))
+    {
+        printf("create %s render elements error!\r\n", render_mode_names[mode]);
+        return -1;
+    }
+    // 不按时钟等待，解码完成即显示
+    g_object_set(G_OBJECT(gst_sink), "sync", FALSE, NULL);
+
+    gst_bin_add(GST_BIN(gst_pipeline), gst_sink);
+    if (gst_conv != NULL)
+    {
+        gst_bin_add(GST_BIN(gst_pipeline), gst_conv);
+        if (!gst_element_link_many(upstream, gst_conv, gst_sink, NULL))
+        {
+            printf("gst_element_link_many error!\r\n");
+            return -1;
+        }
+    }
+    else if (!gst_element_link(upstream, gst_sink))
+    {
+        printf("gst_element_link error!\r\n");
+        return -1;
+    }
+    // 将X11窗口句柄绑定到sink元素上
+    gst_video_overlay_set_window_handle(GST_VIDEO_OVERLAY(gst_sink), window);
+
+    // 添加显示路径CPU时间统计探针
+    GstPad *pad = gst_element_get_static_pad(upstream, "src");
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, render_start_probe, stats, NULL);
+    gst_object_unref(pad);
+    if (gst_conv != NULL)
+    {
+        pad = gst_element_get_static_pad(gst_conv, "src");
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, convert_done_probe, stats, NULL);
+        gst_object_unref(pad);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 为单路视频流创建接收、解封装、解析、解码元素并加入管道。
+ *
+ * @param stream 视频流描述
+ * @param index 视频流序号，用于元素命名和拼接布局
+ * @param mixer 拼接模式下的合成器元素，非拼接模式传NULL
+ * @param mode 独立窗口模式下的显示路径
+ *
+ * @return int 返回0表示成功，返回-1表示失败
+ */
+static int add_stream(StreamCtx_S *stream, int index, GstElement *mixer, RenderMode_E mode)
+{
+    char name[32];
+    const char *codec = stream->h265 ? "h265" : "h264";
+
+    // 创建UDP源，监听指定端口
+    snprintf(name, sizeof(name), "source%d", index);
+    GstElement *gst_src = gst_element_factory_make("udpsrc", name);
+    if (gst_src == NULL)
+    {
+        printf("create udpsrc error!\r\n");
+        return -1;
+    }
+    GstCaps *caps = gst_caps_new_simple("application/x-rtp", "media", G_TYPE_STRING, "video", "encoding-name", G_TYPE_STRING, stream->h265 ? "H265" : "H264", NULL);
+    // 用上次缓存的参数集预置解封装器，加入时只需等待IDR帧即可解码
+    param_sets_load(stream);
+    if (stream->h265 && stream->param_sets[0] && stream->param_sets[1] && stream->param_sets[2])
+    {
+        gst_caps_set_simple(caps,
+                            "sprop-vps", G_TYPE_STRING, stream->param_sets[0],
+                            "sprop-sps", G_TYPE_STRING, stream->param_sets[1],
+                            "sprop-pps", G_TYPE_STRING, stream->param_sets[2],
+                            NULL);
+    }
+    else if (!stream->h265 && stream->param_sets[1] && stream->param_sets[2])
+    {
+        gchar *sprop = g_strdup_printf("%s,%s", stream->param_sets[1], stream->param_sets[2]);
+        gst_caps_set_simple(caps, "sprop-parameter-sets", G_TYPE_STRING, sprop, NULL);
+        g_free(sprop);
+    }
+    g_object_set(G_OBJECT(gst_src), "port", stream->port, "caps", caps, NULL);
+    gst_caps_unref(caps);
+    // 调整缓冲区大小以提高实时性能
     g_object_set(G_OBJECT(gst_src), "buffer-size", 200000, NULL); // 示例缓冲区大小
-    g_object_set(G_OBJECT(gst_src), "latency", 0, NULL);          // 设置延迟为0以降低延迟
 
-    // 创建RTP解封装器以从RTP包中提取H265数据
-    gst_depayloader = gst_element_factory_make("rtph265depay", "depayloader");
+    // 根据编码类型创建RTP解封装器、解析器和解码器
+    char factory[32];
+    snprintf(factory, sizeof(factory), "rtp%sdepay", codec);
+    GstElement *gst_depayloader = gst_element_factory_make(factory, NULL);
+    // 解封装器输出带起始码的码流，参数集保留在码流中，便于缓存
+    GstElement *gst_depay_filter = gst_element_factory_make("capsfilter", NULL);
+    caps = gst_caps_new_simple(stream->h265 ? "video/x-h265" : "video/x-h264",
+                               "stream-format", G_TYPE_STRING, "byte-stream",
+                               "alignment", G_TYPE_STRING, "au", NULL);
+    g_object_set(G_OBJECT(gst_depay_filter), "caps", caps, NULL);
+    gst_caps_unref(caps);
+    snprintf(factory, sizeof(factory), "%sparse", codec);
+    GstElement *gst_parser = gst_element_factory_make(factory, NULL);
+    snprintf(factory, sizeof(factory), "avdec_%s", codec);
+    GstElement *gst_decoder = gst_element_factory_make(factory, NULL);
+    GstElement *queue = gst_element_factory_make("queue", NULL); // 解码与显示之间的队列，使两者运行在不同线程
 
-    // 创建H265解析器，用于解析H265流
-    gst_parser = gst_element_factory_make("h265parse", NULL);
+    if (!gst_depayloader || !gst_depay_filter || !gst_parser || !gst_decoder || !queue)
+    {
+        printf("create %s elements error!\r\n", codec);
+        return -1;
+    }
 
-    // 创建H265解码器，将H265数据解码为原始视频格式
-    gst_decoder = gst_element_factory_make("avdec_h265", NULL);
+    // 限制解码器线程数，保证所有流的解码线程总数不超过预算
+    g_object_set(G_OBJECT(gst_decoder), "max-threads", stream->decoder_threads, NULL);
 
-    // 创建视频转换元素，以处理视频格式转换
-    gst_conv = gst_element_factory_make("videoconvert", NULL);
+    gst_bin_add_many(GST_BIN(gst_pipeline), gst_src, gst_depayloader, gst_depay_filter, gst_parser, gst_decoder, queue, NULL);
+    if (!gst_element_link_many(gst_src, gst_depayloader, gst_depay_filter, gst_parser, gst_decoder, queue, NULL))
+    {
+        printf("gst_element_link_many error!\r\n");
+        return -1;
+    }
 
-    // 创建视频显示元素，使用X11显示接收视频
-    gst_sink = gst_element_factory_make("glimagesink", "sink"); // 使用glimagesink获取更好的性能
-    queue = gst_element_factory_make("queue", "queue");         // 添加一个队列用于缓冲帧
+    if (mixer != NULL)
+    {
+        // 拼接模式：连接到合成器，并按网格排布
+        int cols = (int)ceil(sqrt(stream_count));
+        GstPad *mixer_pad = gst_element_request_pad_simple(mixer, "sink_%u");
+        g_object_set(G_OBJECT(mixer_pad),
+                     "xpos", (index % cols) * MOSAIC_CELL_WIDTH,
+                     "ypos", (index / cols) * MOSAIC_CELL_HEIGHT,
+                     "width", MOSAIC_CELL_WIDTH,
+                     "height", MOSAIC_CELL_HEIGHT,
+                     NULL);
+        GstPad *queue_pad = gst_element_get_static_pad(queue, "src");
+        GstPadLinkReturn lret = gst_pad_link(queue_pad, mixer_pad);
+        gst_object_unref(queue_pad);
+        gst_object_unref(mixer_pad);
+        if (lret != GST_PAD_LINK_OK)
+        {
+            printf("link stream %d to mixer error!\r\n", index);
+            return -1;
+        }
+    }
+    else
+    {
+        // 独立窗口模式：每路流使用自己的显示路径
+        if (add_render_chain(queue, stream->win, mode, &stream->render_stats) != 0)
+        {
+            return -1;
+        }
+    }
+
+    // 添加统计探针
+    GstPad *pad = gst_element_get_static_pad(gst_src, "src");
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, ingress_probe, stream, NULL);
+    gst_object_unref(pad);
+    pad = gst_element_get_static_pad(gst_depay_filter, "src");
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, param_sets_probe, stream, NULL);
+    gst_object_unref(pad);
+    pad = gst_element_get_static_pad(queue, "src");
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, render_probe, stream, NULL);
+    gst_object_unref(pad);
 
-    // 将所有元素添加到管道中
-    gst_bin_add_many(GST_BIN(gst_pipeline), gst_src, gst_depayloader, gst_parser, gst_decoder, queue, gst_conv, gst_sink, NULL);
+    return 0;
+}
 
-    // 连接所有元素，形成处理链路
-    if (gst_element_link_many(gst_src, gst_depayloader, gst_parser, gst_decoder, queue, gst_conv, gst_sink, NULL) == 0)
+/**
+ * @brief 使用指定的显示路径创建管道并开始播放。
+ *
+ * @param mode 显示路径，不能为RenderMode_E_AUTO
+ *
+ * @return GstStateChangeReturn 切换到PLAYING状态的返回值
+ */
+static GstStateChangeReturn build_pipeline(RenderMode_E mode)
+{
+    GstElement *mixer = NULL; // 拼接模式下的合成器
+
+    // 创建一个新的GStreamer管道
+    gst_pipeline = gst_pipeline_new("xvoverlay");
+    active_render_mode = mode;
+
+    if (mosaic)
     {
-        printf("gst_element_link_many error!\r\n"); // 如果链接失败，打印错误信息
+        // gl路径使用glvideomixer，各路解码输出上传为GL纹理后在GPU上缩放、混合，直接交给glimagesink；
+        // 其他路径使用compositor在CPU上缩放、混合，属于CPU转换路径，不在零拷贝显示之列
+        mixer = gst_element_factory_make(mode == RenderMode_E_GL ? "glvideomixer" : "compositor", "mixer");
+        if (!mixer)
+        {
+            printf("create mosaic elements error!\r\n");
+            return GST_STATE_CHANGE_FAILURE;
+        }
+        // glvideomixer是封装了上传元素的bin，合成器属性和信号在其内部的mixer元素上
+        GstElement *aggregator = g_object_ref(mixer);
+        if (g_object_class_find_property(G_OBJECT_GET_CLASS(mixer), "mixer"))
+        {
+            g_object_unref(aggregator);
+            g_object_get(G_OBJECT(mixer), "mixer", &aggregator, NULL);
+        }
+        if (aggregator != NULL)
+        {
+            // 某一路流中断时不阻塞其他流的合成（GStreamer 1.20及以上支持）
+            if (g_object_class_find_property(G_OBJECT_GET_CLASS(aggregator), "ignore-inactive-pads"))
+            {
+                g_object_set(G_OBJECT(aggregator), "ignore-inactive-pads", TRUE, NULL);
+            }
+            // 合成开始时间用于单独统计合成的CPU时间（GStreamer 1.18及以上支持）
+            if (g_object_class_find_property(G_OBJECT_GET_CLASS(aggregator), "emit-signals"))
+            {
+                g_object_set(G_OBJECT(aggregator), "emit-signals", TRUE, NULL);
+                g_signal_connect(aggregator, "samples-selected", G_CALLBACK(mix_start_cb), &mosaic_render_stats);
+            }
+            g_object_unref(aggregator);
+        }
+        gst_bin_add(GST_BIN(gst_pipeline), mixer);
+        if (add_render_chain(mixer, win, mode, &mosaic_render_stats) != 0)
+        {
+            return GST_STATE_CHANGE_FAILURE;
+        }
     }
 
-    // 将X11窗口句柄绑定到GStreamer的sink元素上，使视频能正确显示在窗口中
-    gst_video_overlay_set_window_handle(GST_VIDEO_OVERLAY(gst_sink), win);
+    for (int i = 0; i < stream_count; i++)
+    {
+        if (add_stream(&streams[i], i, mixer, mode) != 0)
+        {
+            // 任一路流无法建立时整个管道失败，由调用者尝试下一种显示路径，避免留下没有画面的窗口
+            printf("add stream %d (port %d) error!\r\n", i, streams[i].port);
+            return GST_STATE_CHANGE_FAILURE;
+        }
+    }
 
     // 改变管道的状态为PLAYING，开始播放
     GstStateChangeReturn sret = gst_element_set_state(gst_pipeline, GST_STATE_PLAYING);
-    printf("set gst playing. sret=%d\r\n", sret); // 打印状态改变的返回值
+    printf("set gst playing. render=%s sret=%d\r\n", render_mode_names[mode], sret); // 打印状态改变的返回值
+    return sret;
+}
+
+/**
+ * @brief 初始化GStreamer管道以播放通过UDP接收的多路视频流。
+ *
+ * @details 所有流共用一个管道，每路流包括源、解封装器、解析器、解码器和队列；
+ * 拼接模式下各路流经合成器输出到同一窗口，否则每路流输出到自己的窗口。
+ * 自动模式下依次尝试gl、xv、x显示路径，显示元素打开失败（如没有GPU或Xv适配器）时换下一种。
+ *
+ * @return 无输出参数。
+ */
+void initGst2(void)
+{
+    static const RenderMode_E candidates[] = {RenderMode_E_GL, RenderMode_E_XV, RenderMode_E_X};
+    static const char *sink_factories[] = {"glimagesink", "xvimagesink", "ximagesink"};
+
+    if (render_mode != RenderMode_E_AUTO)
+    {
+        if (build_pipeline(render_mode) == GST_STATE_CHANGE_FAILURE)
+        {
+            printf("render path %s unavailable!\r\n", render_mode_names[render_mode]);
+            gst_element_set_state(gst_pipeline, GST_STATE_NULL);
+            gst_object_unref(gst_pipeline);
+            gst_pipeline = NULL;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+    {
+        GstElementFactory *factory = gst_element_factory_find(sink_factories[i]);
+        if (factory == NULL)
+        {
+            continue; // 未安装对应插件
+        }
+        gst_object_unref(factory);
+
+        if (build_pipeline(candidates[i]) != GST_STATE_CHANGE_FAILURE)
+        {
+            return;
+        }
+        printf("render path %s unavailable, falling back\r\n", render_mode_names[candidates[i]]);
+        gst_element_set_state(gst_pipeline, GST_STATE_NULL);
+        gst_object_unref(gst_pipeline);
+        gst_pipeline = NULL;
+    }
+    printf("no usable render path!\r\n");
+}
+
+/**
+ * @brief 解析形如 "port:codec" 的视频流参数。
+ *
+ * @param arg 参数字符串，codec 为 h264 或 h265，省略时默认为 h265
+ * @param stream 输出的视频流描述
+ *
+ * @return int 返回0表示成功，返回-1表示参数无效
+ */
+static int parse_stream(const char *arg, StreamCtx_S *stream)
+{
+    const char *sep = strchr(arg, ':');
+    const char *codec = sep ? sep + 1 : DEFAULT_CODEC;
+
+    stream->port = atoi(arg);
+    if (stream->port <= 0 || stream->port > 65535)
+    {
+        return -1;
+    }
+    if (strcmp(codec, "h265") == 0)
+    {
+        stream->h265 = TRUE;
+    }
+    else if (strcmp(codec, "h264") == 0)
+    {
+        stream->h265 = FALSE;
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 程序的使用说明
+ *
+ * @param program_name 程序名称字符串
+ */
+void display_usage(const char *program_name)
+{
+    fprintf(stderr, "Usage: %s [-s port:codec(h264|h265)]... [-t decoder_threads] [-m] [-R render(auto|gl|xv|x|convert)] [-V]\n", program_name);
+    fprintf(stderr, "  -s  add a stream, may be repeated up to %d times (default %d:%s)\n", MAX_STREAMS, DEFAULT_PORT, DEFAULT_CODEC);
+    fprintf(stderr, "  -t  total decoder thread budget shared by all streams (default: number of CPUs)\n");
+    fprintf(stderr, "  -m  mosaic mode, show all streams in one window (gl: glvideomixer on the GPU, other paths: compositor on the CPU)\n");
+    fprintf(stderr, "  -R  render path: gl (YUV to GL shader), xv (planar YUV overlay), x (software), convert (videoconvert + GL), default auto\n");
+    fprintf(stderr, "  -V  keep vsync on the GL path (default off for minimum display latency)\n");
+    fprintf(stderr, "For example: %s -s 5600:h265 -s 5601:h264 -t 4 -m\n", program_name);
 }
 
 /**
- * @brief 主程序入口，初始化GStreamer并创建一个X11窗口。
+ * @brief 主程序入口，初始化GStreamer并创建X11窗口。
  *
- * @details 此函数负责初始化GStreamer库、打开X11显示以及创建和管理窗口；
+ * @details 此函数负责初始化GStreamer库、解析视频流参数、打开X11显示以及创建和管理窗口；
  * 最后，它等待用户释放按钮事件以销毁窗口并关闭显示。
  *
  * @param argc 输入参数，命令行参数数量。
@@ -88,6 +902,80 @@ int main(int argc, char *argv[])
     /* 初始化GStreamer库 */
     gst_init(&argc, &argv); // 初始化GStreamer库，处理任何命令行参数
 
+    // 解析命令行参数
+    int decoder_budget = (int)sysconf(_SC_NPROCESSORS_ONLN); // 解码线程总预算，默认为CPU核数
+    gboolean vsync = FALSE;                                  // GL显示路径是否等待垂直同步
+    int c;
+    while ((c = getopt(argc, argv, "s:t:mR:V")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            if (stream_count >= MAX_STREAMS || parse_stream(optarg, &streams[stream_count]) != 0)
+            {
+                display_usage(argv[0]);
+                return 1;
+            }
+            stream_count++;
+            break;
+        case 't':
+            decoder_budget = atoi(optarg);
+            break;
+        case 'm':
+            mosaic = TRUE;
+            break;
+        case 'R':
+            for (render_mode = RenderMode_E_AUTO; render_mode < RenderMode_E_COUNT; render_mode++)
+            {
+                if (strcmp(optarg, render_mode_names[render_mode]) == 0)
+                {
+                    break;
+                }
+            }
+            if (render_mode == RenderMode_E_COUNT)
+            {
+                display_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'V':
+            vsync = TRUE;
+            break;
+        default:
+            display_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // 未指定视频流时，保持原有的单路H265接收行为
+    if (stream_count == 0)
+    {
+        streams[0].port = DEFAULT_PORT;
+        streams[0].h265 = TRUE;
+        stream_count = 1;
+    }
+
+    // 将解码线程预算平均分配给各路流，余数分配给前几路
+    if (decoder_budget < stream_count)
+    {
+        fprintf(stderr, "decoder thread budget %d is less than stream count %d, using 1 thread per stream\n", decoder_budget, stream_count);
+        decoder_budget = stream_count;
+    }
+    for (int i = 0; i < stream_count; i++)
+    {
+        streams[i].decoder_threads = decoder_budget / stream_count + (i < decoder_budget % stream_count ? 1 : 0);
+        g_mutex_init(&streams[i].lock);
+        g_mutex_init(&streams[i].render_stats.lock);
+    }
+    g_mutex_init(&mosaic_render_stats.lock);
+
+    // 关闭GL交换缓冲区时的垂直同步（Mesa和NVIDIA驱动），不覆盖用户已设置的环境变量
+    if (!vsync)
+    {
+        g_setenv("vblank_mode", "0", FALSE);
+        g_setenv("__GL_SYNC_TO_VBLANK", "0", FALSE);
+    }
+
     // 打开一个显示，连接到默认的X显示
     Display *dsp = XOpenDisplay(NULL);
     if (!dsp) // 检查是否成功打开显示
@@ -100,27 +988,52 @@ int main(int argc, char *argv[])
     unsigned long white = WhitePixel(dsp, screenNumber); // 获取白色像素值
     unsigned long black = BlackPixel(dsp, screenNumber); // 获取黑色像素值
 
-    // 创建一个简单的窗口
-    win = XCreateSimpleWindow(dsp,
-                              DefaultRootWindow(dsp), // 根窗口
-                              50, 50,                 // 窗口的位置
-                              800, 600,               // 窗口的大小
-                              0, black,               // 窗口边框颜色为黑色
-                              white);                 // 窗口背景颜色为白色
-
-    XMapWindow(dsp, win); // 显示窗口
-
-    long eventMask = StructureNotifyMask; // 设置事件掩码以捕捉窗口结构事件
-    XSelectInput(dsp, win, eventMask);    // 选择输入事件
+    // 创建窗口：拼接模式或单路流时只创建一个窗口，否则每路流一个窗口并层叠排列
+    int window_count = (mosaic || stream_count == 1) ? 1 : stream_count;
+    for (int i = 0; i < window_count; i++)
+    {
+        Window w = XCreateSimpleWindow(dsp,
+                                       DefaultRootWindow(dsp), // 根窗口
+                                       50 + i * 40, 50 + i * 40, // 窗口的位置
+                                       800, 600,               // 窗口的大小
+                                       0, black,               // 窗口边框颜色为黑色
+                                       white);                 // 窗口背景颜色为白色
+        XMapWindow(dsp, w);                                    // 显示窗口
+        XSelectInput(dsp, w, StructureNotifyMask);             // 选择输入事件，捕捉窗口结构事件
+        if (i == 0)
+        {
+            win = w;
+        }
+        streams[i].win = w;
+    }
 
     XEvent evt; // 定义X事件
+    int mapped = 0;
     do
     {
         XNextEvent(dsp, &evt); // 等待并处理下一个事件
-    } while (evt.type != MapNotify); // 等待窗口被映射结束
+        if (evt.type == MapNotify)
+        {
+            mapped++;
+        }
+    } while (mapped < window_count); // 等待所有窗口被映射结束
 
     // 创建具体的视频处理管道，并绑定刚才的创建的窗口
     initGst2();
+    if (gst_pipeline == NULL)
+    {
+        // 没有可用的显示路径或有视频流无法建立，不留下没有画面的窗口
+        for (int i = 0; i < window_count; i++)
+        {
+            XDestroyWindow(dsp, streams[i].win);
+        }
+        XCloseDisplay(dsp);
+        return -1;
+    }
+
+    // 启动统计线程
+    stats_running = TRUE;
+    GThread *stats = g_thread_new("stats", stats_thread, NULL);
 
     // 等待直到用户释放鼠标按钮
     do
@@ -128,9 +1041,15 @@ int main(int argc, char *argv[])
         XNextEvent(dsp, &evt); // 一直处理事件，直到捕捉到按钮释放事件
     } while (evt.type != ButtonRelease);
 
+    stats_running = FALSE;
+    g_thread_join(stats);
+
     // 销毁窗口和关闭显示
-    XDestroyWindow(dsp, win); // 销毁创建的窗口
-    XCloseDisplay(dsp);       // 关闭与X服务器的连接
+    for (int i = 0; i < window_count; i++)
+    {
+        XDestroyWindow(dsp, streams[i].win); // 销毁创建的窗口
+    }
+    XCloseDisplay(dsp); // 关闭与X服务器的连接
 
     return 0; // 返回0表示程序成功结束
-}
\ No newline at end of file
+}